@@ -0,0 +1,53 @@
+// Email: shanig7531@gmail.com
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <iostream>
+#include <random>
+#include <vector>
+#include "IndexSort.hpp"
+
+using namespace Container;
+
+/**
+ * @brief Compares the sorting network with std::sort on packed (key, index) values of each small size.
+ * @details This is the choice IndexSort::packed_sort makes for containers of up to NETWORK_SIZE
+ * elements; the network should win from NETWORK_MIN_SIZE up.
+ */
+int main() {
+    const size_t rounds = 1000000;
+    std::mt19937_64 rng(1);
+    std::vector<uint64_t> input(rounds * IndexSort::NETWORK_SIZE);
+    for (uint64_t& x : input) {
+        x = rng();
+    }
+
+    uint64_t sink = 0; // Keeps the sorts from being optimized away
+    std::cout << "n    network (ns)  std::sort (ns)\n";
+    for (size_t n = 2; n <= IndexSort::NETWORK_SIZE; ++n) {
+        auto start = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            uint64_t v[IndexSort::NETWORK_SIZE];
+            for (size_t i = 0; i < IndexSort::NETWORK_SIZE; ++i) {
+                v[i] = i < n ? input[r * IndexSort::NETWORK_SIZE + i] : UINT64_MAX;
+            }
+            IndexSort::network_sort(v);
+            sink += v[r % n];
+        }
+        auto middle = std::chrono::steady_clock::now();
+        for (size_t r = 0; r < rounds; ++r) {
+            uint64_t v[IndexSort::NETWORK_SIZE];
+            std::copy_n(input.begin() + static_cast<std::ptrdiff_t>(r * IndexSort::NETWORK_SIZE), n, v);
+            std::sort(v, v + n);
+            sink += v[r % n];
+        }
+        auto end = std::chrono::steady_clock::now();
+
+        std::chrono::duration<double, std::nano> network = middle - start, sorted = end - middle;
+        std::cout << n << (n < 10 ? "    " : "   ") << network.count() / rounds << "\t  "
+                  << sorted.count() / rounds << "\n";
+    }
+    std::cerr << sink % 2 << "\n";
+    return 0;
+}
@@ -3,11 +3,27 @@
 #define DOCTEST_CONFIG_IMPLEMENT_WITH_MAIN
 #include "doctest.h"
 #include "MyContainer.hpp"
+#include "SmallContainer.hpp"
 #include <string>
 #include <stdexcept>
+#include <numeric>
+#include <memory>
+#include <memory_resource>
+#include <optional>
+#include <sstream>
+#include <thread>
 
 using namespace Container;
 
+// Trivially copyable type without a default constructor, ordered by its first member only
+struct Version {
+    int major;
+    int minor;
+    Version(int ma, int mi) : major(ma), minor(mi) {}
+    bool operator<(const Version& other) const { return major < other.major; }
+    bool operator==(const Version& other) const { return major == other.major && minor == other.minor; }
+};
+
 TEST_CASE("Empty Container Tests") {
     MyContainer<> container;
     CHECK(container.size() == 0);
@@ -952,4 +968,1374 @@ TEST_CASE("Error Handling and Edge Cases") {
         MyContainer<long> longContainer;
         CHECK_THROWS_AS(*longContainer.begin_middleout(), std::out_of_range);
     }
-}
\ No newline at end of file
+}
+TEST_CASE("Sorted Index Cache") {
+    SUBCASE("Cache Is Invalidated By Add") {
+        MyContainer<int> container;
+        container.add(5);
+        container.add(1);
+        CHECK(*container.begin_asc() == 1);
+        CHECK(*container.begin_desc() == 5);
+
+        container.add(0);
+        container.add(9);
+        CHECK(*container.begin_asc() == 0);
+        CHECK(*container.begin_desc() == 9);
+        CHECK(*container.begin_sidecross() == 0);
+    }
+
+    SUBCASE("Cache Is Invalidated By Remove") {
+        MyContainer<int> container;
+        container.add(3);
+        container.add(1);
+        container.add(4);
+        CHECK(*container.begin_asc() == 1);
+
+        container.remove(1);
+        std::vector<int> expected = {3, 4};
+        std::vector<int> result;
+        for (auto it = container.begin_asc(); it != container.end_asc(); ++it) {
+            result.push_back(*it);
+        }
+        CHECK(result == expected);
+    }
+
+    SUBCASE("Failed Remove Keeps Cache Valid") {
+        MyContainer<int> container;
+        container.add(2);
+        container.add(1);
+        CHECK(*container.begin_asc() == 1);
+        CHECK_THROWS_AS(container.remove(7), std::runtime_error);
+        CHECK(*container.begin_asc() == 1);
+    }
+
+    SUBCASE("Copies Keep Independent Caches") {
+        MyContainer<int> container;
+        container.add(2);
+        container.add(1);
+        CHECK(*container.begin_asc() == 1);
+
+        MyContainer<int> copy = container;
+        copy.add(0);
+        CHECK(*copy.begin_asc() == 0);
+        CHECK(*container.begin_asc() == 1);
+    }
+}
+
+TEST_CASE("Iterator Copies Share Indices") {
+    MyContainer<int> container;
+    container.add(4);
+    container.add(2);
+    container.add(8);
+
+    auto it = container.begin_asc();
+    auto copy = it;
+    CHECK(*copy == 2);
+    ++copy;
+    CHECK(*copy == 4);
+    CHECK(*it == 2); // Advancing the copy does not move the original
+
+    // An iterator keeps its permutation alive after the container rebuilds its cache
+    auto old_desc = container.begin_desc();
+    container.add(1);
+    CHECK(*container.begin_desc() == 8);
+    CHECK(*old_desc == 8);
+}
+
+TEST_CASE("Incremental Sorted Index") {
+    SUBCASE("Interleaved Adds And Reads") {
+        MyContainer<int> container;
+        container.set_incremental_sort(true);
+        container.add(5);
+        container.add(1);
+        CHECK(*container.begin_asc() == 1);
+        CHECK(*container.begin_desc() == 5);
+
+        container.add(3);
+        container.add(7);
+        container.add(3);
+        std::vector<int> asc, desc;
+        for (auto it = container.begin_asc(); it != container.end_asc(); ++it) {
+            asc.push_back(*it);
+        }
+        for (auto it = container.begin_desc(); it != container.end_desc(); ++it) {
+            desc.push_back(*it);
+        }
+        CHECK(asc == std::vector<int>{1, 3, 3, 5, 7});
+        CHECK(desc == std::vector<int>{7, 5, 3, 3, 1});
+    }
+
+    SUBCASE("Remove Renumbers The Permutation") {
+        MyContainer<int> container;
+        container.set_incremental_sort(true);
+        container.add(4);
+        container.add(2);
+        container.add(9);
+        container.add(2);
+        container.add(6);
+        CHECK(*container.begin_asc() == 2);
+
+        container.remove(2);
+        std::vector<int> sidecross;
+        for (auto it = container.begin_sidecross(); it != container.end_sidecross(); ++it) {
+            sidecross.push_back(*it);
+        }
+        CHECK(sidecross == std::vector<int>{4, 9, 6});
+    }
+
+    SUBCASE("Live Iterators Keep Their Permutation") {
+        MyContainer<int> container;
+        container.set_incremental_sort(true);
+        container.add(3);
+        container.add(1);
+        auto it = container.begin_asc();
+        container.add(0);
+        CHECK(*it == 1); // The shared buffer was copied before the insert
+        CHECK(*container.begin_asc() == 0);
+    }
+}
+
+TEST_CASE("Lazy Sorted Index") {
+    SUBCASE("Top K Traversal") {
+        MyContainer<int> container;
+        container.set_lazy_sort(true);
+        for (int v : {9, 4, 7, 1, 8, 3, 6}) {
+            container.add(v);
+        }
+
+        std::vector<int> lowest, highest;
+        for (auto it = container.begin_asc(); it != container.end_asc() && lowest.size() < 3; ++it) {
+            lowest.push_back(*it);
+        }
+        for (auto it = container.begin_desc(); it != container.end_desc() && highest.size() < 2; ++it) {
+            highest.push_back(*it);
+        }
+        CHECK(lowest == std::vector<int>{1, 3, 4});
+        CHECK(highest == std::vector<int>{9, 8});
+    }
+
+    SUBCASE("Full Traversal Matches Eager Order") {
+        MyContainer<std::string> eager, lazy;
+        lazy.set_lazy_sort(true);
+        for (const char* s : {"pear", "fig", "apple", "kiwi", "fig", "banana"}) {
+            eager.add(s);
+            lazy.add(s);
+        }
+        std::vector<std::string> expected, result;
+        for (auto it = eager.begin_asc(); it != eager.end_asc(); ++it) {
+            expected.push_back(*it);
+        }
+        for (auto it = lazy.begin_asc(); it != lazy.end_asc(); ++it) {
+            result.push_back(*it);
+        }
+        CHECK(result == expected);
+
+        std::vector<std::string> sidecross;
+        for (auto it = lazy.begin_sidecross(); it != lazy.end_sidecross(); ++it) {
+            sidecross.push_back(*it);
+        }
+        CHECK(sidecross == std::vector<std::string>{"apple", "pear", "banana", "kiwi", "fig", "fig"});
+    }
+
+    SUBCASE("Combined With Incremental Maintenance") {
+        MyContainer<int> container;
+        container.set_lazy_sort(true);
+        container.set_incremental_sort(true);
+        container.add(5);
+        container.add(2);
+        container.add(8);
+        CHECK(*container.begin_asc() == 2); // Only the first position is sorted here
+        container.add(1);
+        container.remove(5);
+        std::vector<int> result;
+        for (auto it = container.begin_asc(); it != container.end_asc(); ++it) {
+            result.push_back(*it);
+        }
+        CHECK(result == std::vector<int>{1, 2, 8});
+    }
+}
+
+TEST_CASE("Radix Sort Engine") {
+    // Enough elements to go past IndexSort::RADIX_THRESHOLD
+    const int n = 1000;
+
+    SUBCASE("Signed Integers") {
+        MyContainer<int> container;
+        std::vector<int> expected;
+        for (int i = 0; i < n; ++i) {
+            int v = (i * 7919) % 2003 - 1000; // Mix of negative and positive values with repeats
+            container.add(v);
+            expected.push_back(v);
+        }
+        std::sort(expected.begin(), expected.end());
+
+        std::vector<int> asc, desc;
+        for (auto it = container.begin_asc(); it != container.end_asc(); ++it) {
+            asc.push_back(*it);
+        }
+        for (auto it = container.begin_desc(); it != container.end_desc(); ++it) {
+            desc.push_back(*it);
+        }
+        CHECK(asc == expected);
+        std::reverse(expected.begin(), expected.end());
+        CHECK(desc == expected);
+    }
+
+    SUBCASE("Long Integers") {
+        MyContainer<long> container;
+        std::vector<long> expected;
+        for (long i = 0; i < n; ++i) {
+            long v = (i % 2 ? -1L : 1L) * (i * 1000003L);
+            container.add(v);
+            expected.push_back(v);
+        }
+        std::sort(expected.begin(), expected.end());
+
+        std::vector<long> asc;
+        for (auto it = container.begin_asc(); it != container.end_asc(); ++it) {
+            asc.push_back(*it);
+        }
+        CHECK(asc == expected);
+    }
+
+    SUBCASE("Doubles") {
+        MyContainer<double> container;
+        std::vector<double> expected;
+        for (int i = 0; i < n; ++i) {
+            double v = (i % 3 - 1) * (i * 0.37);
+            container.add(v);
+            expected.push_back(v);
+        }
+        std::sort(expected.begin(), expected.end());
+
+        std::vector<double> asc;
+        for (auto it = container.begin_asc(); it != container.end_asc(); ++it) {
+            asc.push_back(*it);
+        }
+        CHECK(asc == expected);
+        CHECK(*container.begin_sidecross() == expected.front());
+    }
+}
+
+TEST_CASE("Pair Sort Engine") {
+    SUBCASE("Trivially Copyable Struct") {
+        MyContainer<Version> container;
+        container.add(Version(3, 0));
+        container.add(Version(1, 1));
+        container.add(Version(2, 0));
+        container.add(Version(1, 0));
+
+        // Equal majors keep insertion order in both directions
+        std::vector<Version> asc, desc;
+        for (auto it = container.begin_asc(); it != container.end_asc(); ++it) {
+            asc.push_back(*it);
+        }
+        for (auto it = container.begin_desc(); it != container.end_desc(); ++it) {
+            desc.push_back(*it);
+        }
+        CHECK(asc == std::vector<Version>{Version(1, 1), Version(1, 0), Version(2, 0), Version(3, 0)});
+        CHECK(desc == std::vector<Version>{Version(3, 0), Version(2, 0), Version(1, 1), Version(1, 0)});
+    }
+
+    SUBCASE("Small Integer Container") {
+        MyContainer<int> container;
+        for (int v : {4, -2, 4, 0, -7}) {
+            container.add(v);
+        }
+        std::vector<int> result;
+        for (auto it = container.begin_desc(); it != container.end_desc(); ++it) {
+            result.push_back(*it);
+        }
+        CHECK(result == std::vector<int>{4, 4, 0, -2, -7});
+    }
+}
+
+TEST_CASE("Parallel Sort Engine") {
+    // Enough elements to go past IndexSort::PARALLEL_THRESHOLD
+    const int n = 100000;
+
+    SUBCASE("Strings") {
+        MyContainer<std::string> container;
+        std::vector<std::string> expected;
+        for (int i = 0; i < n; ++i) {
+            std::string s = std::to_string((i * 7919) % 65521);
+            container.add(s);
+            expected.push_back(s);
+        }
+        std::sort(expected.begin(), expected.end());
+
+        std::vector<std::string> asc;
+        for (auto it = container.begin_asc(); it != container.end_asc(); ++it) {
+            asc.push_back(*it);
+        }
+        CHECK(asc == expected);
+        CHECK(*container.begin_desc() == expected.back());
+    }
+
+    SUBCASE("Packed Pairs Keep Ties In Insertion Order") {
+        MyContainer<Version> container;
+        for (int i = 0; i < n; ++i) {
+            container.add(Version(i % 100, i));
+        }
+        bool ordered = true;
+        auto prev = container.begin_asc();
+        for (auto it = ++container.begin_asc(); it != container.end_asc(); ++it, ++prev) {
+            const Version& a = *prev;
+            const Version& b = *it;
+            if (b < a || (a.major == b.major && b.minor < a.minor)) {
+                ordered = false;
+            }
+        }
+        CHECK(ordered);
+    }
+
+    SUBCASE("Explicit Worker Counts") {
+        // Independent of the cores on the machine running the tests
+        std::vector<int> values(1000);
+        for (size_t i = 0; i < values.size(); ++i) {
+            values[i] = static_cast<int>((i * 7919) % 1000);
+        }
+        for (size_t workers : {2, 3, 4, 7}) {
+            std::vector<int> sorted = values;
+            IndexSort::sort_range(sorted.begin(), sorted.end(), std::less<int>(), workers);
+            CHECK(std::is_sorted(sorted.begin(), sorted.end()));
+            CHECK(sorted.front() == 0);
+            CHECK(sorted.back() == 999);
+        }
+
+        std::vector<int> tiny{3, 1, 2};
+        IndexSort::sort_range(tiny.begin(), tiny.end(), std::less<int>(), 8); // More workers than elements
+        CHECK(tiny == std::vector<int>{1, 2, 3});
+    }
+
+    SUBCASE("Comparator Exceptions Reach The Caller") {
+        std::vector<int> values(1000);
+        std::iota(values.rbegin(), values.rend(), 0);
+        auto throwing = [](int a, int b) {
+            if (a == 500 || b == 500) {
+                throw std::runtime_error("comparison failed");
+            }
+            return a < b;
+        };
+        CHECK_THROWS_AS(IndexSort::sort_range(values.begin(), values.end(), throwing, 3), std::runtime_error);
+    }
+}
+
+TEST_CASE("Small Container Sort Network") {
+    SUBCASE("Floats With Negatives And Zeros") {
+        MyContainer<float> container;
+        for (float v : {2.5f, -1.0f, 0.0f, -0.0f, 7.25f, -3.5f, 2.5f}) {
+            container.add(v);
+        }
+        std::vector<float> asc;
+        for (auto it = container.begin_asc(); it != container.end_asc(); ++it) {
+            asc.push_back(*it);
+        }
+        CHECK(asc == std::vector<float>{-3.5f, -1.0f, 0.0f, -0.0f, 2.5f, 2.5f, 7.25f});
+    }
+
+    SUBCASE("Sizes Around The Network Width") {
+        for (int n : {7, 8, 15, 16, 17, 40}) {
+            MyContainer<int> container;
+            std::vector<int> expected;
+            for (int i = 0; i < n; ++i) {
+                int v = (i * 37) % 11 - 5;
+                container.add(v);
+                expected.push_back(v);
+            }
+            std::sort(expected.begin(), expected.end(), [](int a, int b) { return a > b; });
+            std::vector<int> desc;
+            for (auto it = container.begin_desc(); it != container.end_desc(); ++it) {
+                desc.push_back(*it);
+            }
+            CHECK(desc == expected);
+        }
+    }
+
+    SUBCASE("Network Matches std::sort") {
+        uint64_t seed = 12345;
+        for (int round = 0; round < 1000; ++round) {
+            uint64_t v[IndexSort::NETWORK_SIZE];
+            for (uint64_t& x : v) {
+                seed = seed * 6364136223846793005ULL + 1442695040888963407ULL;
+                x = (seed >> 33) % 20; // Many duplicates
+            }
+            std::vector<uint64_t> expected(std::begin(v), std::end(v));
+            std::sort(expected.begin(), expected.end());
+            IndexSort::network_sort(v);
+            CHECK(std::vector<uint64_t>(std::begin(v), std::end(v)) == expected);
+        }
+    }
+}
+
+TEST_CASE("Middle Out Index Mapping") {
+    // Reference order: middle first, then alternate left and right while each side has elements
+    for (int n = 1; n <= 9; ++n) {
+        MyContainer<int> container;
+        for (int i = 0; i < n; ++i) {
+            container.add(i);
+        }
+        std::vector<int> expected = {n / 2};
+        int left = n / 2 - 1, right = n / 2 + 1;
+        while (static_cast<int>(expected.size()) < n) {
+            if (left >= 0) expected.push_back(left--);
+            if (right < n) expected.push_back(right++);
+        }
+
+        std::vector<int> result;
+        for (auto it = container.begin_middleout(); it != container.end_middleout(); ++it) {
+            result.push_back(*it);
+        }
+        CHECK(result == expected);
+    }
+}
+
+TEST_CASE("Random Access Iterators") {
+    MyContainer<int> container;
+    for (int v : {7, 15, 6, 1, 2}) {
+        container.add(v);
+    }
+
+    SUBCASE("Iterator Traits") {
+        using Traits = std::iterator_traits<AscendingOrderIterator<int>>;
+        CHECK(std::is_same<Traits::iterator_category, std::random_access_iterator_tag>::value);
+        CHECK(std::is_same<Traits::value_type, int>::value);
+        CHECK(std::is_same<std::iterator_traits<ReverseOrderIterator<int>>::reference, const int&>::value);
+    }
+
+    SUBCASE("Distance And Advance") {
+        CHECK(std::distance(container.begin_asc(), container.end_asc()) == 5);
+        CHECK(container.end_middleout() - container.begin_middleout() == 5);
+
+        auto it = container.begin_desc();
+        std::advance(it, 3);
+        CHECK(*it == 2);
+        it -= 2;
+        CHECK(*it == 7);
+        CHECK(*(it + 1) == 6);
+        CHECK(*(1 + it) == 6);
+        CHECK(it[2] == 2);
+    }
+
+    SUBCASE("Decrement From End") {
+        auto asc = container.end_asc();
+        --asc;
+        CHECK(*asc == 15);
+        auto side = container.end_sidecross();
+        side--;
+        CHECK(*side == 6);
+        auto rev = container.end_reverse();
+        CHECK(*--rev == 7);
+        auto order = container.end_order();
+        CHECK(*std::prev(order) == 2);
+        CHECK_THROWS_AS(--container.begin_order(), std::out_of_range);
+    }
+
+    SUBCASE("Binary Search Over Sorted View") {
+        auto found = std::lower_bound(container.begin_asc(), container.end_asc(), 6);
+        CHECK(*found == 6);
+        CHECK(found - container.begin_asc() == 2);
+        CHECK(std::binary_search(container.begin_asc(), container.end_asc(), 15));
+        CHECK_FALSE(std::binary_search(container.begin_asc(), container.end_asc(), 3));
+    }
+
+    SUBCASE("Ordering And Bounds") {
+        auto first = container.begin_reverse();
+        auto last = container.end_reverse();
+        CHECK(first < last);
+        CHECK(last > first);
+        CHECK(first <= first);
+        CHECK(last >= first);
+        CHECK_THROWS_AS(first + 6, std::out_of_range);
+        CHECK_THROWS_AS(first - 1, std::out_of_range);
+        CHECK_THROWS_AS(last[0], std::out_of_range);
+    }
+
+    SUBCASE("Assignment") {
+        auto it = container.begin_asc();
+        auto other = container.end_asc();
+        it = other;
+        CHECK(it == container.end_asc());
+        std::vector<int> collected(container.begin_sidecross(), container.end_sidecross());
+        CHECK(collected == std::vector<int>{1, 15, 2, 7, 6});
+    }
+}
+
+TEST_CASE("Contiguous Element Access") {
+    MyContainer<int> container;
+    CHECK(container.begin_raw() == container.end_raw());
+
+    for (int v : {3, 1, 4, 1, 5}) {
+        container.add(v);
+    }
+    CHECK(container.end_raw() - container.begin_raw() == 5);
+    CHECK(std::accumulate(container.begin_raw(), container.end_raw(), 0) == 14);
+    CHECK(std::accumulate(container.begin_order(), container.end_order(), 0) == 14);
+
+    std::vector<int> copy(container.begin_raw(), container.end_raw());
+    CHECK(copy == std::vector<int>{3, 1, 4, 1, 5});
+    CHECK(&*container.begin_order() == container.begin_raw());
+    CHECK(&*container.begin_reverse() == container.end_raw() - 1);
+}
+
+TEST_CASE("Bounds Check Policy") {
+    MyContainer<int> container;
+    for (int v : {5, 3, 8}) {
+        container.add(v);
+    }
+
+    SUBCASE("Default Policy Checks In Debug Builds") {
+        CHECK(std::is_same<decltype(container.begin_asc()), AscendingOrderIterator<int, DefaultBounds>>::value);
+#ifndef NDEBUG
+        CHECK(std::is_same<DefaultBounds, Checked>::value);
+        CHECK_THROWS_AS(*container.end_middleout(), std::out_of_range);
+#endif
+    }
+
+    SUBCASE("Explicit Checked Policy") {
+        auto it = container.end_desc<Checked>();
+        CHECK_THROWS_AS(*it, std::out_of_range);
+        CHECK_THROWS_AS(++it, std::out_of_range);
+        CHECK_THROWS_AS(--container.begin_sidecross<Checked>(), std::out_of_range);
+    }
+
+    SUBCASE("Unchecked Iterators Traverse Normally") {
+        std::vector<int> asc, side, rev;
+        for (auto it = container.begin_asc<Unchecked>(); it != container.end_asc<Unchecked>(); ++it) {
+            asc.push_back(*it);
+        }
+        for (auto it = container.begin_sidecross<Unchecked>(); it != container.end_sidecross<Unchecked>(); ++it) {
+            side.push_back(*it);
+        }
+        for (auto it = container.begin_reverse<Unchecked>(); it != container.end_reverse<Unchecked>(); ++it) {
+            rev.push_back(*it);
+        }
+        CHECK(asc == std::vector<int>{3, 5, 8});
+        CHECK(side == std::vector<int>{3, 8, 5});
+        CHECK(rev == std::vector<int>{8, 3, 5});
+        CHECK(std::accumulate(container.begin_order<Unchecked>(), container.end_order<Unchecked>(), 0) == 16);
+        CHECK(container.end_middleout<Unchecked>() - container.begin_middleout<Unchecked>() == 3);
+    }
+}
+
+TEST_CASE("Iterators Survive Mutation") {
+    MyContainer<int> container;
+    for (int v : {50, 10, 40, 20, 30}) {
+        container.add(v);
+    }
+
+    SUBCASE("Ascending Keeps Its Element After Add") {
+        auto it = container.begin_asc();
+        auto end = container.end_asc();
+        ++it; // 20
+        container.add(5);
+        container.add(25);
+        CHECK(*it == 20);
+        std::vector<int> rest(it, end);
+        CHECK(rest == std::vector<int>{20, 25, 30, 40, 50});
+        CHECK(end - container.begin_asc() == 7);
+    }
+
+    SUBCASE("Removed Element Moves To Next") {
+        auto it = container.begin_asc() + 2; // 30
+        container.remove(30);
+        CHECK(*it == 40);
+        container.remove(10);
+        CHECK(*it == 40);
+        CHECK(it - container.begin_asc() == 1);
+        container.remove(50);
+        ++it;
+        CHECK(it == container.end_asc());
+    }
+
+    SUBCASE("Descending Follows Mutation") {
+        auto it = container.begin_desc() + 1; // 40
+        container.add(45);
+        container.remove(50);
+        CHECK(*it == 40);
+        std::vector<int> rest(it, container.end_desc());
+        CHECK(rest == std::vector<int>{40, 30, 20, 10});
+    }
+
+    SUBCASE("SideCross Follows Mutation") {
+        auto it = container.begin_sidecross() + 2; // 10, 50, 20
+        container.add(60);
+        CHECK(*it == 20);
+        std::vector<int> rest(it, container.end_sidecross());
+        CHECK(rest == std::vector<int>{20, 50, 30, 40});
+    }
+
+    SUBCASE("Equal Elements Keep Their Place") {
+        container.add(20);
+        auto it = container.begin_asc() + 2; // Second 20
+        container.add(20);
+        container.remove(10);
+        CHECK(it - container.begin_asc() == 1);
+        std::vector<int> rest(it, container.end_asc());
+        CHECK(rest == std::vector<int>{20, 20, 30, 40, 50});
+    }
+
+    SUBCASE("Patched Index Matches A Fresh Sort") {
+        auto it = container.begin_asc();
+        for (int v : {35, 5, 45, 35}) {
+            container.add(v);
+        }
+        container.remove(40);
+        CHECK(*it == 10);
+        MyContainer<int> fresh;
+        for (int v : {50, 10, 20, 30, 35, 5, 45, 35}) {
+            fresh.add(v);
+        }
+        CHECK(std::equal(container.begin_asc(), container.end_asc(), fresh.begin_asc(), fresh.end_asc()));
+        CHECK(std::equal(container.begin_desc(), container.end_desc(), fresh.begin_desc(), fresh.end_desc()));
+    }
+
+    SUBCASE("Removed Elements Are Destroyed") {
+        auto token = std::make_shared<int>(7);
+        MyContainer<std::shared_ptr<int>> handles;
+        handles.add(token);
+        handles.add(std::make_shared<int>(8));
+        auto it = handles.begin_asc();
+        handles.remove(token);
+        CHECK(token.use_count() == 1);
+        CHECK(it != handles.end_asc());
+    }
+
+    SUBCASE("Iterator Past The Log Moves To The End") {
+        MyContainer<int> many;
+        for (int v = 0; v < 200; ++v) {
+            many.add(v);
+        }
+        auto it = many.begin_asc();
+        it += 150;
+        CHECK(*it == 150);
+        for (int v = 0; v < 65; ++v) {
+            many.remove(v);
+        }
+        CHECK(it == many.end_asc());
+        it = many.begin_asc();
+        CHECK(*it == 65);
+    }
+}
+
+TEST_CASE("Bulk Add") {
+    SUBCASE("Move And Emplace") {
+        MyContainer<std::string> container;
+        std::string word = "banana";
+        container.add(std::move(word));
+        container.emplace(3, 'c');
+        container.emplace("apple");
+        CHECK(container.size() == 3);
+        std::vector<std::string> asc(container.begin_asc(), container.end_asc());
+        CHECK(asc == std::vector<std::string>{"apple", "banana", "ccc"});
+    }
+
+    SUBCASE("Range And Initializer List") {
+        MyContainer<int> container;
+        container.reserve(8);
+        const int* storage = container.begin_raw();
+        container.add({4, 2});
+        std::vector<int> more{9, 1, 2};
+        container.add_range(more.begin(), more.end());
+        container.add_range(more.end(), more.end());
+        CHECK(container.begin_raw() == storage);
+        std::vector<int> order(container.begin_order(), container.end_order());
+        CHECK(order == std::vector<int>{4, 2, 9, 1, 2});
+    }
+
+    SUBCASE("Moved Range") {
+        MyContainer<std::string> container;
+        std::vector<std::string> words{"pear", "fig"};
+        container.add_range(std::make_move_iterator(words.begin()), std::make_move_iterator(words.end()));
+        CHECK(container.size() == 2);
+        CHECK(*container.begin_asc() == "fig");
+    }
+
+    SUBCASE("Sorted Iterators See The Batch") {
+        MyContainer<int> container;
+        container.set_incremental_sort(true);
+        container.add({5, 1});
+        auto it = container.begin_asc(); // 1
+        container.add({3, 0, 5});
+        CHECK(*it == 1);
+        std::vector<int> asc(container.begin_asc(), container.end_asc());
+        std::vector<int> desc(container.begin_desc(), container.end_desc());
+        CHECK(asc == std::vector<int>{0, 1, 3, 5, 5});
+        CHECK(desc == std::vector<int>{5, 5, 3, 1, 0});
+        container.add(2);
+        container.remove(5);
+        std::vector<int> side(container.begin_sidecross(), container.end_sidecross());
+        CHECK(side == std::vector<int>{0, 3, 1, 2});
+    }
+}
+
+TEST_CASE("Batch Remove") {
+    MyContainer<int> container;
+    container.add({5, 3, 8, 3, 1, 9, 5});
+
+    SUBCASE("Try Remove Does Not Throw") {
+        CHECK(container.try_remove(3) == 2);
+        CHECK(container.try_remove(42) == 0);
+        CHECK(container.size() == 5);
+        CHECK_THROWS_AS(container.remove(3), std::runtime_error);
+    }
+
+    SUBCASE("Remove All Skips Missing Values") {
+        std::vector<int> values{5, 7, 1};
+        CHECK(container.remove_all(values) == 3);
+        CHECK(container.remove_all({100, 200}) == 0);
+        std::vector<int> order(container.begin_order(), container.end_order());
+        CHECK(order == std::vector<int>{3, 8, 3, 9});
+    }
+
+    SUBCASE("Remove If") {
+        CHECK(container.remove_if([](int v) { return v % 2 == 1; }) == 6);
+        CHECK(container.size() == 1);
+        CHECK(*container.begin_order() == 8);
+    }
+
+    SUBCASE("Sorted Iterators Follow A Batch") {
+        auto it = container.begin_asc() + 3; // Second 5
+        auto desc = container.begin_desc(); // 9
+        CHECK(container.remove_all({3, 9, 5}) == 5);
+        CHECK(*it == 8);
+        CHECK(*desc == 8);
+        std::vector<int> asc(container.begin_asc(), container.end_asc());
+        CHECK(asc == std::vector<int>{1, 8});
+    }
+
+    SUBCASE("Incremental Sort") {
+        container.set_incremental_sort(true);
+        CHECK(*container.begin_asc() == 1);
+        container.remove_if([](int v) { return v < 5; });
+        std::vector<int> asc(container.begin_asc(), container.end_asc());
+        std::vector<int> desc(container.begin_desc(), container.end_desc());
+        CHECK(asc == std::vector<int>{5, 5, 8, 9});
+        CHECK(desc == std::vector<int>{9, 8, 5, 5});
+    }
+
+    SUBCASE("Values Without std::hash") {
+        MyContainer<Version> versions;
+        versions.add({Version(1, 0), Version(2, 0), Version(2, 1), Version(3, 0)});
+        std::vector<Version> gone{Version(2, 0), Version(4, 0)};
+        CHECK(versions.remove_all(gone) == 1);
+        CHECK(versions.size() == 3);
+        CHECK(versions.begin_asc()[1] == Version(2, 1));
+    }
+}
+
+TEST_CASE("Value Index") {
+    MyContainer<std::string> container;
+    container.add({"b", "a", "c", "a", "d"});
+
+    SUBCASE("Queries Without The Index") {
+        CHECK(container.contains("a"));
+        CHECK_FALSE(container.contains("z"));
+        CHECK(container.count("a") == 2);
+    }
+
+    SUBCASE("Index Follows Adds And Removes") {
+        container.set_value_index(true);
+        CHECK(container.count("a") == 2);
+        CHECK(container.try_remove("z") == 0);
+        container.add("z");
+        container.add({"a", "e"});
+        CHECK(container.count("a") == 3);
+        CHECK(container.contains("z"));
+
+        container.remove("a");
+        CHECK_FALSE(container.contains("a"));
+        CHECK_THROWS_AS(container.remove("a"), std::runtime_error);
+        CHECK(container.remove_if([](const std::string& s) { return s == "b" || s == "e"; }) == 2);
+        std::vector<std::string> order(container.begin_order(), container.end_order());
+        CHECK(order == std::vector<std::string>{"c", "d", "z"});
+
+        // Positions were renumbered: removing by index lookup takes the right elements
+        container.remove("d");
+        order.assign(container.begin_order(), container.end_order());
+        CHECK(order == std::vector<std::string>{"c", "z"});
+        CHECK(container.count("c") == 1);
+    }
+
+    SUBCASE("Sorted Iterators With The Index") {
+        container.set_value_index(true);
+        auto it = container.begin_asc() + 2; // "b"
+        container.remove("a");
+        CHECK(*it == "b");
+        CHECK(it == container.begin_asc());
+    }
+
+    SUBCASE("Turning The Index Off") {
+        container.set_value_index(true);
+        container.set_value_index(false);
+        container.remove("a");
+        CHECK(container.count("a") == 0);
+        CHECK(container.size() == 3);
+    }
+}
+
+TEST_CASE("Deferred Remove") {
+    MyContainer<int> container;
+    container.add({7, 3, 9, 1, 5, 3, 8, 2, 6, 4, 0, 11});
+    container.set_deferred_remove(true);
+
+    SUBCASE("Removed Elements Are Gone Before Compaction") {
+        container.remove(3);
+        CHECK(container.size() == 10);
+        CHECK_FALSE(container.contains(3));
+        CHECK(container.try_remove(3) == 0);
+        CHECK_THROWS_AS(container.remove(3), std::runtime_error);
+        std::vector<int> order(container.begin_order(), container.end_order());
+        CHECK(order == std::vector<int>{7, 9, 1, 5, 8, 2, 6, 4, 0, 11});
+        CHECK(container.end_raw() - container.begin_raw() == 10);
+    }
+
+    SUBCASE("Every Traversal Sees Compacted Storage") {
+        container.remove(9);
+        container.remove(0);
+        std::vector<int> rev(container.begin_reverse(), container.end_reverse());
+        CHECK(rev == std::vector<int>{11, 4, 6, 2, 8, 3, 5, 1, 3, 7});
+        container.remove(11);
+        std::vector<int> middle(container.begin_middleout(), container.end_middleout());
+        CHECK(middle.size() == 9);
+        CHECK(middle.front() == 3);
+        container.remove(7);
+        std::vector<int> side(container.begin_sidecross(), container.end_sidecross());
+        CHECK(side == std::vector<int>{1, 8, 2, 6, 3, 5, 3, 4});
+    }
+
+    SUBCASE("Sorted Iterators And Cached Permutations") {
+        auto it = container.begin_asc() + 4; // First 3... 0, 1, 2, 3, 3
+        auto desc = container.begin_desc(); // 11
+        container.remove(3);
+        container.remove(11);
+        CHECK(*it == 4);
+        CHECK(*desc == 9);
+        std::vector<int> asc(container.begin_asc(), container.end_asc());
+        CHECK(asc == std::vector<int>{0, 1, 2, 4, 5, 6, 7, 8, 9});
+    }
+
+    SUBCASE("Sorted Iterators Catch Up Against An Earlier End") {
+        auto it = container.begin_asc() + 10; // 9
+        auto end = container.end_asc();
+        container.remove(7);
+        container.remove(0);
+        CHECK(*it == 9);
+        CHECK(end - it == 2);
+        ++it;
+        ++it;
+        CHECK(it == end);
+    }
+
+    SUBCASE("Unsorted Iterators Held Across A Remove") {
+        MyContainer<int> numbers;
+        numbers.add({1, 2, 3, 4, 5, 6, 7, 8});
+        numbers.set_deferred_remove(true);
+        auto order = numbers.begin_order();
+        auto last = numbers.begin_order() + 7;
+        auto order_end = numbers.end_order();
+        auto rev = numbers.begin_reverse();
+        auto rev_end = numbers.end_reverse();
+        auto middle = numbers.begin_middleout();
+        auto middle_end = numbers.end_middleout();
+        numbers.remove(1);
+        numbers.remove(5);
+
+        CHECK(*order == 2);
+        CHECK(*last == 8);
+        CHECK(*rev == 8);
+        CHECK(*middle == 4); // 5 was in the middle, 4 comes next
+        CHECK(order_end - order == 6);
+        CHECK(std::vector<int>(order, order_end) == std::vector<int>{2, 3, 4, 6, 7, 8});
+        CHECK(std::vector<int>(rev, rev_end) == std::vector<int>{8, 7, 6, 4, 3, 2});
+        CHECK(std::vector<int>(middle, middle_end) == std::vector<int>{4, 6, 3, 7, 2, 8});
+        CHECK(*(order + 3) == 6);
+        CHECK(*(order_end - 1) == 8);
+        CHECK(*--(last - 2) == 4);
+        CHECK(*(rev + 5) == 2);
+        CHECK_THROWS_AS(--numbers.begin_order(), std::out_of_range);
+    }
+
+    SUBCASE("Printing Skips Tombstones") {
+        container.remove(3);
+        container.remove(11);
+        std::ostringstream os;
+        os << container;
+        CHECK(os.str() == "[7, 9, 1, 5, 8, 2, 6, 4, 0]");
+    }
+
+    SUBCASE("Compaction With Incremental Sort And Value Index") {
+        container.set_incremental_sort(true);
+        container.set_value_index(true);
+        CHECK(*container.begin_desc() == 11);
+        container.remove(3);
+        container.add(3);
+        container.remove(8);
+        container.compact();
+        CHECK(container.count(3) == 1);
+        std::vector<int> asc(container.begin_asc(), container.end_asc());
+        std::vector<int> desc(container.begin_desc(), container.end_desc());
+        CHECK(asc == std::vector<int>{0, 1, 2, 3, 4, 5, 6, 7, 9, 11});
+        CHECK(desc == std::vector<int>{11, 9, 7, 6, 5, 4, 3, 2, 1, 0});
+        container.remove(11);
+        CHECK(*container.begin_order() == 7);
+        CHECK(container.count(11) == 0);
+    }
+
+    SUBCASE("Threshold Compaction And Turning It Off") {
+        MyContainer<int> copy = container;
+        for (int v : {7, 9, 1, 5}) {
+            copy.remove(v); // Crosses the threshold on the fourth remove
+        }
+        CHECK(copy.size() == 8);
+        copy.set_deferred_remove(false);
+        copy.remove(0);
+        std::vector<int> order(copy.begin_order(), copy.end_order());
+        CHECK(order == std::vector<int>{3, 3, 8, 2, 6, 4, 11});
+        CHECK(container.size() == 12);
+    }
+}
+
+TEST_CASE("Compact Index Width") {
+    std::pmr::vector<int> keys{5, 3, 8, 3, 1, 9};
+
+    SUBCASE("32-bit Indices Up To 2^32 Elements") {
+        CHECK(SortedIndex<int>::fits_narrow(0));
+        CHECK(SortedIndex<int>::fits_narrow(size_t(1) << 32));
+        CHECK_FALSE(SortedIndex<int>::fits_narrow((size_t(1) << 32) + 1));
+        CHECK_FALSE(SortedIndex<int>(keys, false, false).wide());
+        CHECK(sizeof(SortedIndex<int>::Narrow::index_type) == 4);
+    }
+
+    SUBCASE("Both Widths Give The Same Order") {
+        for (bool lazy : {false, true}) {
+            SortedIndex<int>::Narrow narrow(keys, true, lazy);
+            SortedIndex<int>::Wide wide(keys, true, lazy);
+            for (size_t pos = 0; pos < keys.size(); ++pos) {
+                CHECK(narrow.at(pos, keys) == wide.at(pos, keys));
+            }
+        }
+        auto reversed = SortedIndex<int>::Wide::reverse_of(SortedIndex<int>::Wide(keys, false, false), keys);
+        CHECK(reversed.complete(keys) == std::pmr::vector<size_t>{5, 2, 0, 1, 3, 4});
+    }
+
+    SUBCASE("Widening Keeps The Order") {
+        SortedIndex<int> index(keys, false, true);
+        CHECK(index.at(0, keys) == 4);
+        index.widen(keys);
+        CHECK(index.wide());
+        CHECK(index.size() == keys.size());
+        std::vector<size_t> order;
+        for (size_t pos = 0; pos < index.size(); ++pos) {
+            order.push_back(index.at(pos, keys));
+        }
+        CHECK(order == std::vector<size_t>{4, 1, 3, 0, 2, 5});
+    }
+}
+
+struct CountingResource : std::pmr::memory_resource {
+    size_t allocations = 0;
+    size_t live = 0;
+
+    void* do_allocate(size_t bytes, size_t align) override {
+        ++allocations;
+        ++live;
+        return std::pmr::new_delete_resource()->allocate(bytes, align);
+    }
+    void do_deallocate(void* p, size_t bytes, size_t align) override {
+        --live;
+        std::pmr::new_delete_resource()->deallocate(p, bytes, align);
+    }
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+        return this == &other;
+    }
+};
+
+TEST_CASE("Memory Resource") {
+    CountingResource arena;
+    CountingResource fallback;
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(&fallback);
+
+    SUBCASE("Elements And Indices Come From The Resource") {
+        {
+            MyContainer<int> container(&arena);
+            CHECK(container.resource() == &arena);
+            container.add({5, 3, 8, 3, 1, 9});
+            std::vector<int> asc(container.begin_asc(), container.end_asc());
+            std::vector<int> desc(container.begin_desc(), container.end_desc());
+            std::vector<int> side(container.begin_sidecross(), container.end_sidecross());
+            CHECK(asc == std::vector<int>{1, 3, 3, 5, 8, 9});
+            CHECK(side == std::vector<int>{1, 9, 3, 8, 3, 5});
+            container.set_value_index(true);
+            container.set_deferred_remove(true);
+            container.remove(3);
+            CHECK(*container.begin_asc() == 1);
+            CHECK(arena.allocations > 0);
+        }
+        CHECK(arena.live == 0);
+        CHECK(fallback.allocations == 0);
+    }
+
+    SUBCASE("Copies Use Their Own Resource") {
+        MyContainer<int> container(&arena);
+        container.add({4, 2, 6});
+        CHECK(*container.begin_asc() == 2);
+
+        MyContainer<int> copy = container;
+        CHECK(copy.resource() == &fallback);
+        MyContainer<int> other(container, &arena);
+        CHECK(other.resource() == &arena);
+        copy.add(1);
+        std::vector<int> asc(copy.begin_asc(), copy.end_asc());
+        CHECK(asc == std::vector<int>{1, 2, 4, 6});
+
+        MyContainer<int> assigned(&arena);
+        assigned = copy;
+        CHECK(assigned.resource() == &arena);
+        CHECK(*assigned.begin_desc() == 6);
+    }
+
+    std::pmr::set_default_resource(previous);
+}
+
+TEST_CASE("Container Footprint") {
+    // Inline: the element handle, both cached permutations with their versions, the cache lock,
+    // the version and log counters, the flags, and one pointer to the rarely used state
+    size_t inline_state = sizeof(SharedStorage<int>) + 2 * (sizeof(std::shared_ptr<int>) + sizeof(size_t))
+        + sizeof(std::mutex) + 2 * sizeof(size_t) + sizeof(void*) + sizeof(size_t);
+    CHECK(sizeof(MyContainer<int>) <= inline_state);
+    CHECK(sizeof(MyContainer<std::string>) == sizeof(MyContainer<int>));
+
+    MyContainer<int> container;
+    container.add({3, 1, 2});
+    container.set_value_index(true);
+    container.set_deferred_remove(true);
+    container.remove(1);
+    MyContainer<int> copy = container;
+    CHECK(copy.count(1) == 0);
+    CHECK(copy.count(3) == 1);
+    CHECK(copy.size() == 2);
+    CHECK(std::vector<int>(copy.begin_asc(), copy.end_asc()) == std::vector<int>{2, 3});
+}
+
+TEST_CASE("Small Container") {
+    CountingResource heap;
+    std::pmr::memory_resource* previous = std::pmr::set_default_resource(&heap);
+
+    SUBCASE("No Heap Allocations Up To N Elements") {
+        SmallContainer<int, 16> container;
+        for (int v : {7, 3, 9, 1, 5, 3, 8, 2, 6, 4, 0, 11, 15, 13, 12, 14}) {
+            container.add(v);
+        }
+        std::vector<int> asc(container.begin_asc(), container.end_asc());
+        std::vector<int> desc(container.begin_desc(), container.end_desc());
+        std::vector<int> side(container.begin_sidecross(), container.end_sidecross());
+        std::vector<int> middle(container.begin_middleout(), container.end_middleout());
+        CHECK(heap.allocations == 0);
+        CHECK(asc.front() == 0);
+        CHECK(desc.front() == 15);
+        CHECK(side[1] == 15);
+        CHECK(middle.front() == 6);
+        CHECK(container.inline_bytes_used() > 0);
+
+        for (int v = 16; v < 100; ++v) {
+            container.add(v); // Far past N: allocations spill over to the upstream resource
+        }
+        CHECK(heap.allocations > 0);
+        CHECK(*container.begin_desc() == 99);
+    }
+
+    SUBCASE("Works Wherever A MyContainer Does") {
+        SmallContainer<std::string, 4> container;
+        container.add({"pear", "fig", "apple"});
+        const MyContainer<std::string>& base = container;
+        CHECK(*base.begin_asc() == "apple");
+
+        SmallContainer<std::string, 4> copy = container;
+        copy.remove("apple");
+        CHECK(*copy.begin_asc() == "fig");
+        CHECK(*container.begin_asc() == "apple");
+        container = copy;
+        CHECK(container.size() == 2);
+        CHECK(container.resource() != copy.resource());
+    }
+
+    SUBCASE("Moving Out Leaves The Arena Behind") {
+        auto make = [] {
+            SmallContainer<int, 8> small;
+            small.add({3, 1, 2});
+            return MyContainer<int>(std::move(small));
+        };
+        MyContainer<int> moved = make();
+        CHECK(moved.resource() == std::pmr::get_default_resource());
+        CHECK(std::vector<int>(moved.begin_asc(), moved.end_asc()) == std::vector<int>{1, 2, 3});
+        moved.add(0);
+        CHECK(*moved.begin_asc() == 0);
+
+        SmallContainer<int, 8> source;
+        source.add(5);
+        MyContainer<int> target(std::move(static_cast<MyContainer<int>&>(source)));
+        CHECK(source.size() == 0);
+        CHECK(target.size() == 1);
+    }
+
+    SUBCASE("Arena Rewinds And Resets") {
+        InlineArena<256> arena(&heap);
+        void* a = arena.allocate(32);
+        void* b = arena.allocate(32);
+        CHECK(arena.used() == 64);
+        arena.deallocate(b, 32);
+        CHECK(arena.used() == 32);
+        void* c = arena.allocate(300); // Does not fit
+        CHECK(heap.allocations == 1);
+        arena.deallocate(c, 300);
+        arena.deallocate(a, 32);
+        CHECK(arena.used() == 0);
+    }
+
+    std::pmr::set_default_resource(previous);
+}
+
+TEST_CASE("Move And Swap") {
+    CHECK(std::is_nothrow_move_constructible<MyContainer<int>>::value);
+    CHECK(std::is_nothrow_move_constructible<MyContainer<std::string>>::value);
+
+    MyContainer<int> container;
+    container.add({5, 3, 8, 1});
+    CHECK(*container.begin_asc() == 1);
+    const int* storage = container.begin_raw();
+
+    SUBCASE("Move Construction Takes The Storage") {
+        MyContainer<int> moved(std::move(container));
+        CHECK(moved.begin_raw() == storage);
+        CHECK(moved.size() == 4);
+        std::vector<int> desc(moved.begin_desc(), moved.end_desc());
+        CHECK(desc == std::vector<int>{8, 5, 3, 1});
+
+        CHECK(container.size() == 0);
+        CHECK(container.begin_asc() == container.end_asc());
+        container.add(2);
+        CHECK(*container.begin_asc() == 2);
+    }
+
+    SUBCASE("Move Assignment") {
+        MyContainer<int> target;
+        target.add(42);
+        target = std::move(container);
+        CHECK(target.begin_raw() == storage);
+        std::vector<int> asc(target.begin_asc(), target.end_asc());
+        CHECK(asc == std::vector<int>{1, 3, 5, 8});
+
+        CountingResource arena;
+        MyContainer<int> elsewhere(&arena);
+        elsewhere = std::move(target);
+        CHECK(elsewhere.resource() == &arena);
+        CHECK(*elsewhere.begin_desc() == 8);
+        CHECK(target.size() == 0);
+        CHECK(target.begin_asc() == target.end_asc());
+    }
+
+    SUBCASE("Across Memory Resources The Elements Move") {
+        MyContainer<std::string> words;
+        words.add({std::string(40, 'b'), std::string(40, 'a')});
+        const char* text = words.begin_order()->data(); // Heap buffer of the first string
+
+        CountingResource arena;
+        MyContainer<std::string> elsewhere(&arena);
+        elsewhere = std::move(words);
+        CHECK(elsewhere.begin_order()->data() == text);
+        CHECK(words.size() == 0);
+        CHECK(*elsewhere.begin_asc() == std::string(40, 'a'));
+
+        MyContainer<std::string> back;
+        back.add("c");
+        back.swap(elsewhere);
+        CHECK(back.begin_order()->data() == text);
+        CHECK(*elsewhere.begin_order() == "c");
+        CHECK(elsewhere.resource() == &arena);
+    }
+
+    SUBCASE("Swap") {
+        MyContainer<int> other;
+        other.add({9, 7});
+        other.set_value_index(true);
+        swap(container, other);
+        CHECK(container.count(9) == 1);
+        CHECK(*container.begin_asc() == 7);
+        CHECK(other.begin_raw() == storage);
+        CHECK(*other.begin_desc() == 8);
+
+        CountingResource arena;
+        MyContainer<int> elsewhere(&arena);
+        elsewhere.add(100);
+        elsewhere.swap(other);
+        CHECK(elsewhere.resource() == &arena);
+        CHECK(elsewhere.size() == 4);
+        CHECK(*other.begin_order() == 100);
+    }
+
+    SUBCASE("Containers In A Vector") {
+        std::vector<MyContainer<int>> many;
+        many.push_back(std::move(container));
+        for (int i = 0; i < 20; ++i) {
+            MyContainer<int> small;
+            small.add(i);
+            many.push_back(std::move(small));
+        }
+        CHECK(many.front().begin_raw() == storage);
+        CHECK(*many.front().begin_desc() == 8);
+        CHECK(*many.back().begin_asc() == 19);
+    }
+
+    SUBCASE("Iterators See Assignment And Swap") {
+        // Both containers reach version 5, a with five adds and b with four adds and a remove
+        MyContainer<int> a;
+        for (int v : {10, 20, 30, 40, 50}) {
+            a.add(v);
+        }
+        MyContainer<int> b;
+        for (int v : {7, 9, 8, 6}) {
+            b.add(v);
+        }
+        b.remove(6);
+
+        auto it = a.begin_asc();
+        ++it;
+        a = b;
+        CHECK(it == a.end_asc());
+        CHECK(std::vector<int>(a.begin_asc(), a.end_asc()) == std::vector<int>{7, 8, 9});
+
+        auto top = a.begin_desc();
+        CHECK(*top == 9);
+        MyContainer<int> c;
+        for (int v : {1, 2, 3, 4, 5}) {
+            c.add(v);
+        }
+        a = std::move(c);
+        CHECK(top == a.end_desc());
+        CHECK(*a.begin_desc() == 5);
+
+        auto low = a.begin_asc();
+        swap(a, b);
+        CHECK(low == a.end_asc());
+        CHECK(*a.begin_desc() == 9);
+        CHECK(*b.begin_desc() == 5);
+    }
+}
+
+TEST_CASE("Snapshots") {
+    MyContainer<int> container;
+    container.add({7, 15, 6, 1, 2});
+    CHECK(*container.begin_asc() == 1);
+    Snapshot<int> snap = container.snapshot();
+
+    SUBCASE("Shares Storage Until A Write") {
+        CHECK(snap.begin_raw() == container.begin_raw());
+        CHECK(snap.size() == 5);
+        container.add(4);
+        CHECK(snap.begin_raw() != container.begin_raw());
+        CHECK(snap.size() == 5);
+        CHECK(container.size() == 6);
+    }
+
+    SUBCASE("Writes Do Not Show Through") {
+        container.remove(15);
+        container.add(20);
+        std::vector<int> asc(snap.begin_asc(), snap.end_asc());
+        CHECK(asc == std::vector<int>{1, 2, 6, 7, 15});
+        std::vector<int> now(container.begin_asc(), container.end_asc());
+        CHECK(now == std::vector<int>{1, 2, 6, 7, 20});
+        CHECK(snap.count(15) == 1);
+        CHECK(!std::is_convertible<Snapshot<int>&, MyContainer<int>&>::value);
+    }
+
+    SUBCASE("All Iterators") {
+        CHECK(std::vector<int>(snap.begin_order(), snap.end_order()) == std::vector<int>{7, 15, 6, 1, 2});
+        CHECK(std::vector<int>(snap.begin_reverse(), snap.end_reverse()) == std::vector<int>{2, 1, 6, 15, 7});
+        CHECK(std::vector<int>(snap.begin_asc(), snap.end_asc()) == std::vector<int>{1, 2, 6, 7, 15});
+        CHECK(std::vector<int>(snap.begin_desc(), snap.end_desc()) == std::vector<int>{15, 7, 6, 2, 1});
+        CHECK(std::vector<int>(snap.begin_sidecross(), snap.end_sidecross()) == std::vector<int>{1, 15, 2, 7, 6});
+        CHECK(std::vector<int>(snap.begin_middleout(), snap.end_middleout()) == std::vector<int>{6, 15, 1, 7, 2});
+    }
+
+    SUBCASE("Pending Tombstones") {
+        MyContainer<int> deferred;
+        deferred.set_deferred_remove(true);
+        deferred.add({1, 2, 3});
+        deferred.remove(2);
+        Snapshot<int> view = deferred.snapshot();
+        CHECK(view.size() == 2);
+        CHECK(std::vector<int>(view.begin_order(), view.end_order()) == std::vector<int>{1, 3});
+    }
+
+    SUBCASE("Same Memory Resource") {
+        CountingResource arena;
+        MyContainer<int> local(&arena);
+        local.add({3, 1, 2});
+        size_t before = arena.allocations;
+        Snapshot<int> view = local.snapshot();
+        CHECK(view.resource() == &arena);
+        CHECK(arena.allocations == before);
+        CHECK(*view.begin_desc() == 3);
+
+        before = arena.allocations;
+        Snapshot<int> copy = view;
+        CHECK(copy.resource() == &arena);
+        CHECK(arena.allocations == before);
+        CHECK(copy.begin_raw() == view.begin_raw());
+        CHECK(*copy.begin_desc() == 3);
+    }
+
+    SUBCASE("Outlives A Small Container") {
+        std::optional<Snapshot<int>> kept;
+        {
+            SmallContainer<int, 8> small;
+            small.add({3, 1, 2});
+            CHECK(*small.begin_asc() == 1);
+            kept.emplace(small.snapshot());
+        }
+        CHECK(kept->resource() == std::pmr::get_default_resource());
+        CHECK(std::vector<int>(kept->begin_asc(), kept->end_asc()) == std::vector<int>{1, 2, 3});
+        std::ostringstream out;
+        out << *kept;
+        CHECK(out.str() == "[3, 1, 2]");
+    }
+}
+
+TEST_CASE("Concurrent Readers") {
+    for (bool lazy : {false, true}) {
+        MyContainer<int> container;
+        container.set_lazy_sort(lazy);
+        for (int v = 0; v < 3000; ++v) {
+            container.add((v * 7919) % 3000);
+        }
+
+        // Several threads build and walk the caches of one const container
+        const MyContainer<int>& shared = container;
+        std::vector<int> asc, desc, side;
+        std::thread up([&] { asc.assign(shared.begin_asc(), shared.end_asc()); });
+        std::thread down([&] { desc.assign(shared.begin_desc(), shared.end_desc()); });
+        std::thread cross([&] { side.assign(shared.begin_sidecross(), shared.end_sidecross()); });
+        std::vector<int> mine(shared.begin_asc(), shared.end_asc());
+        up.join();
+        down.join();
+        cross.join();
+        CHECK(asc == mine);
+        CHECK(std::is_sorted(asc.begin(), asc.end()));
+        CHECK(std::equal(desc.rbegin(), desc.rend(), asc.begin(), asc.end()));
+        CHECK(side.front() == 0);
+        CHECK(side[1] == 2999);
+
+        // A snapshot is read on another thread while the container changes
+        Snapshot<int> snap = container.snapshot();
+        std::vector<int> seen;
+        std::thread reader([&] { seen.assign(snap.begin_asc(), snap.end_asc()); });
+        for (int v = 0; v < 100; ++v) {
+            container.remove(v);
+            container.add(v + 5000);
+        }
+        reader.join();
+        CHECK(seen == asc);
+        CHECK(*container.begin_asc() == 100);
+    }
+}
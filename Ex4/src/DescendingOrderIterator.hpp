@@ -3,9 +3,12 @@
 #ifndef DESCENDING_ORDER_ITERATOR_HPP
 #define DESCENDING_ORDER_ITERATOR_HPP
 
-#include <vector>
-#include <algorithm>
+#include <memory>
 #include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include "IteratorChecks.hpp"
+#include "SortedIndex.hpp"
 
 namespace Container {
 
@@ -15,38 +18,100 @@ namespace Container {
     /**
      * @brief Iterator for traversing the container in descending order.
      * @tparam T The type of elements stored in the container.
+     * @tparam Bounds Checked to throw std::out_of_range on misuse, Unchecked to drop the checks.
      */
-    template<typename T>
+    template<typename T, typename Bounds = DefaultBounds>
     class DescendingOrderIterator {
 
     private:
-        const MyContainer<T>& container; // Reference to the container being iterated
-        std::vector<size_t> indices; // Indices of elements in descending order
-        size_t pos; // Current position in the indices vector
+        const MyContainer<T>* container; // Container being iterated (a pointer, so iterators are assignable)
+        mutable std::shared_ptr<const SortedIndex<T>> indices; // Shared, immutable indices of elements in descending order
+        mutable size_t pos; // Current position in descending order
+        mutable size_t version; // Container version that indices and pos refer to
+
+        /**
+         * @brief Returns the container's cached descending permutation, fetching it on first use.
+         * @return The shared permutation this iterator walks.
+         */
+        const SortedIndex<T>& sorted() const {
+            if (!indices) {
+                indices = container->descending_indices();
+            }
+            return *indices;
+        }
 
         /**
-         * @brief Builds the indices vector sorted by the container's elements in descending order.
+         * @brief Checks whether the container changed since this iterator last caught up with it.
+         * @return True if pos and indices refer to an older version of the container.
          */
-        void build_indices() {
-            indices.resize(container.size());
-            for (size_t i = 0; i < container.size(); ++i) {
-                indices[i] = i;
+        bool stale() const {
+            return container != nullptr && version != container->version;
+        }
+
+        /**
+         * @brief Catches up with the container if it changed. Stepping and comparing skip this,
+         * so a traversal pays for one version check per dereference.
+         */
+        void sync() const {
+            if (stale()) {
+                resync();
+            }
+        }
+
+        /**
+         * @brief Catches up with add()/remove() calls made since this iterator last looked at the container.
+         * @details The iterator stays on the element it pointed at, or moves to the next one in order if
+         * that element was removed. An iterator that never fetched the permutation was at the end and
+         * stays there. Kept out of line so the checks that call it stay small enough to inline.
+         */
+        CONTAINER_NOINLINE void resync() const {
+            if (indices) {
+                auto current = container->descending_indices();
+                pos = container->track_position(*indices, pos, version, *current, true);
+                indices = std::move(current);
+            } else {
+                pos = container->size();
+            }
+            version = container->version;
+        }
+
+        /**
+         * @brief Brings two iterators to the same container version before their positions are compared.
+         * @details Iterators taken at the same version compare positions directly, which is the common
+         * case of a loop against an end iterator taken alongside it.
+         * @param other The iterator to compare with.
+         */
+        void align(const DescendingOrderIterator& other) const {
+            if (version != other.version) {
+                sync();
+                other.sync();
             }
-            std::sort(indices.begin(), indices.end(),
-                [this](size_t a, size_t b) {
-                    return container.data[a] > container.data[b];
-                });
         }
 
     public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        /**
+         * @brief Default constructor. Creates a singular iterator that may only be assigned to or compared.
+         */
+        DescendingOrderIterator() : container(nullptr), pos(0), version(0) {}
+
         /**
          * @brief Constructor for the DescendingOrderIterator.
          * @param cont Reference to the container.
          * @param start_pos The starting position for the iterator (default is 0).
+         * @note An iterator constructed at or past the end only compares positions,
+         * so it skips fetching the permutation until it is first dereferenced.
          */
         DescendingOrderIterator(const MyContainer<T>& cont, size_t start_pos = 0)
-            : container(cont), pos(start_pos) {
-            build_indices();
+            : container(&cont), pos(start_pos), version(cont.version) {
+            if (pos < container->size()) {
+                sorted();
+            }
         }
 
         /**
@@ -55,10 +120,30 @@ namespace Container {
          * @throw std::out_of_range If iterator is out of bounds
          */
         const T& operator*() const {
-            if (pos >= container.size()) {
+            sync();
+            if (Bounds::enabled && pos >= container->size()) {
                 throw std::out_of_range("Iterator out of bounds");
             }
-            return container.data[indices[pos]];
+            return container->data[sorted().at(pos, container->data)];
+        }
+
+        /**
+         * @brief Member access operator.
+         * @return Pointer to the current element in the container.
+         * @throw std::out_of_range If iterator is out of bounds
+         */
+        const T* operator->() const {
+            return &**this;
+        }
+
+        /**
+         * @brief Subscript operator.
+         * @param n Offset from the current position.
+         * @return Reference to the element n positions away.
+         * @throw std::out_of_range If the position is out of bounds
+         */
+        const T& operator[](difference_type n) const {
+            return *(*this + n);
         }
 
         /**
@@ -67,8 +152,11 @@ namespace Container {
          * @throw std::out_of_range If incrementing past the end
          */
         DescendingOrderIterator& operator++() {
-            if (pos >= container.size()) {
-                throw std::out_of_range("Cannot increment iterator past end");
+            if (Bounds::enabled && pos >= container->size()) {
+                sync(); // The container may have grown since
+                if (pos >= container->size()) {
+                    throw std::out_of_range("Cannot increment iterator past end");
+                }
             }
             ++pos;
             return *this;
@@ -76,25 +164,120 @@ namespace Container {
 
         /**
          * @brief Post-increment operator.
-         * @return Iterator to the position before increment.
+         * @return Copy of iterator before increment.
          * @throw std::out_of_range If incrementing past the end
          */
         DescendingOrderIterator operator++(int) {
-            if (pos >= container.size()) {
-                throw std::out_of_range("Cannot increment iterator past end");
+            DescendingOrderIterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        /**
+         * @brief Pre-decrement operator.
+         * @return Reference to the iterator after decrement.
+         * @throw std::out_of_range If decrementing before the beginning
+         */
+        DescendingOrderIterator& operator--() {
+            if (Bounds::enabled && pos == 0) {
+                throw std::out_of_range("Cannot decrement iterator before begin");
             }
+            --pos;
+            return *this;
+        }
+
+        /**
+         * @brief Post-decrement operator.
+         * @return Copy of iterator before decrement.
+         * @throw std::out_of_range If decrementing before the beginning
+         */
+        DescendingOrderIterator operator--(int) {
             DescendingOrderIterator temp = *this;
-            ++pos;
+            --*this;
             return temp;
         }
 
+        /**
+         * @brief Moves the iterator by n positions.
+         * @param n Number of positions, negative to move backwards.
+         * @return Reference to the moved iterator.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        DescendingOrderIterator& operator+=(difference_type n) {
+            difference_type target = static_cast<difference_type>(pos) + n;
+            if (Bounds::enabled && (target < 0 || static_cast<size_t>(target) > container->size())) {
+                sync(); // The container may have changed since
+                target = static_cast<difference_type>(pos) + n;
+                if (target < 0 || static_cast<size_t>(target) > container->size()) {
+                    throw std::out_of_range("Cannot move iterator out of bounds");
+                }
+            }
+            pos = static_cast<size_t>(target);
+            return *this;
+        }
+
+        /**
+         * @brief Moves the iterator back by n positions.
+         * @param n Number of positions, negative to move forwards.
+         * @return Reference to the moved iterator.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        DescendingOrderIterator& operator-=(difference_type n) {
+            return *this += -n;
+        }
+
+        /**
+         * @brief Returns an iterator n positions ahead.
+         * @param n Number of positions, negative to move backwards.
+         * @return The moved copy.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        DescendingOrderIterator operator+(difference_type n) const {
+            DescendingOrderIterator temp = *this;
+            return temp += n;
+        }
+
+        /**
+         * @brief Returns an iterator n positions ahead.
+         * @param n Number of positions, negative to move backwards.
+         * @param it The iterator to move.
+         * @return The moved copy.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        friend DescendingOrderIterator operator+(difference_type n, const DescendingOrderIterator& it) {
+            return it + n;
+        }
+
+        /**
+         * @brief Returns an iterator n positions back.
+         * @param n Number of positions, negative to move forwards.
+         * @return The moved copy.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        DescendingOrderIterator operator-(difference_type n) const {
+            DescendingOrderIterator temp = *this;
+            return temp -= n;
+        }
+
+        /**
+         * @brief Distance between two iterators over the same container.
+         * @param other The iterator to measure from.
+         * @return Number of increments needed to get from other to this iterator.
+         */
+        difference_type operator-(const DescendingOrderIterator& other) const {
+            sync();
+            other.sync();
+            return static_cast<difference_type>(pos) - static_cast<difference_type>(other.pos);
+        }
+
         /**
          * @brief Equality comparison operator.
          * @param other Another iterator to compare.
          * @return True if both iterators are at the same position and container.
          */
         bool operator==(const DescendingOrderIterator& other) const {
-            return pos == other.pos && &container == &other.container;
+            align(other);
+            return pos == other.pos && container == other.container;
         }
 
         /**
@@ -105,6 +288,43 @@ namespace Container {
         bool operator!=(const DescendingOrderIterator& other) const {
             return !(*this == other);
         }
+
+        /**
+         * @brief Less-than comparison operator.
+         * @param other Another iterator over the same container.
+         * @return True if this iterator is before other.
+         */
+        bool operator<(const DescendingOrderIterator& other) const {
+            align(other);
+            return pos < other.pos;
+        }
+
+        /**
+         * @brief Greater-than comparison operator.
+         * @param other Another iterator over the same container.
+         * @return True if this iterator is after other.
+         */
+        bool operator>(const DescendingOrderIterator& other) const {
+            return other < *this;
+        }
+
+        /**
+         * @brief Less-than-or-equal comparison operator.
+         * @param other Another iterator over the same container.
+         * @return True if this iterator is not after other.
+         */
+        bool operator<=(const DescendingOrderIterator& other) const {
+            return !(other < *this);
+        }
+
+        /**
+         * @brief Greater-than-or-equal comparison operator.
+         * @param other Another iterator over the same container.
+         * @return True if this iterator is not before other.
+         */
+        bool operator>=(const DescendingOrderIterator& other) const {
+            return !(*this < other);
+        }
     };
 
 } // namespace Container
@@ -0,0 +1,434 @@
+// Email: shanig7531@gmail.com
+
+#ifndef INDEX_SORT_HPP
+#define INDEX_SORT_HPP
+
+#include <vector>
+#include <memory_resource>
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <exception>
+#include <limits>
+#include <system_error>
+#include <thread>
+#include <type_traits>
+#include <utility>
+
+namespace Container {
+
+    /**
+     * @brief Sorting engines that build the permutations used by the sorted-order iterators.
+     * @details All engines produce the same permutation: elements by value, equal elements by
+     * insertion index. The engine is chosen at compile time from the element type and at run time
+     * from the number of elements; comparison sorts of large containers run on several threads.
+     */
+    namespace IndexSort {
+
+        constexpr size_t RADIX_THRESHOLD = 256; // Below this many elements a comparison sort is faster
+        constexpr size_t PARALLEL_THRESHOLD = size_t(1) << 15; // Below this many elements threads cost more than they save
+
+        /**
+         * @brief Runs task(0) ... task(count - 1) concurrently, one thread per task.
+         * @details The calling thread runs the last task itself. If a task throws, the first
+         * exception is rethrown here once every thread has finished.
+         * @param count Number of tasks.
+         * @param task Callable taking the task number.
+         */
+        template<typename Task>
+        void run_parallel(size_t count, const Task& task) {
+            std::vector<std::exception_ptr> errors(count);
+            auto guarded = [&task, &errors](size_t i) {
+                try {
+                    task(i);
+                } catch (...) {
+                    errors[i] = std::current_exception();
+                }
+            };
+            std::vector<std::thread> threads;
+            threads.reserve(count - 1);
+            for (size_t i = 0; i + 1 < count; ++i) {
+                try {
+                    threads.emplace_back(guarded, i);
+                } catch (const std::system_error&) {
+                    guarded(i); // No thread available, run the task here instead
+                }
+            }
+            guarded(count - 1);
+            for (std::thread& thread : threads) {
+                thread.join();
+            }
+            for (const std::exception_ptr& error : errors) {
+                if (error) {
+                    std::rethrow_exception(error);
+                }
+            }
+        }
+
+        /**
+         * @brief Sorts a range with a given number of threads.
+         * @details The range is cut into one chunk per worker, the chunks are sorted concurrently
+         * and then merged pairwise, each round of merges also running concurrently. With fewer
+         * than two workers (or elements) this is std::sort.
+         * @param first Start of the range.
+         * @param last End of the range.
+         * @param cmp Strict weak ordering; called from several threads at once.
+         * @param workers Number of chunks, and so of threads.
+         * @throw Whatever cmp throws, once every thread has finished.
+         */
+        template<typename Iter, typename Compare>
+        void sort_range(Iter first, Iter last, Compare cmp, size_t workers) {
+            const size_t n = static_cast<size_t>(last - first);
+            workers = std::min(workers, n);
+            if (workers < 2) {
+                std::sort(first, last, cmp);
+                return;
+            }
+
+            std::vector<Iter> bounds(workers + 1);
+            for (size_t i = 0; i <= workers; ++i) {
+                bounds[i] = first + static_cast<std::ptrdiff_t>(n * i / workers);
+            }
+            run_parallel(workers, [&bounds, &cmp](size_t i) {
+                std::sort(bounds[i], bounds[i + 1], cmp);
+            });
+
+            // Merge neighbouring sorted chunks until one is left
+            for (size_t width = 1; width < workers; width *= 2) {
+                size_t merges = (workers + 2 * width - 1) / (2 * width);
+                run_parallel(merges, [&bounds, &cmp, width, workers](size_t m) {
+                    size_t left = m * 2 * width;
+                    size_t mid = std::min(left + width, workers);
+                    size_t right = std::min(left + 2 * width, workers);
+                    if (mid < right) {
+                        std::inplace_merge(bounds[left], bounds[mid], bounds[right], cmp);
+                    }
+                });
+            }
+        }
+
+        /**
+         * @brief Sorts a range, splitting large ranges across the available cores.
+         * @details Ranges of at least PARALLEL_THRESHOLD elements get one worker per core, but at
+         * least PARALLEL_THRESHOLD / 2 elements per worker. Smaller ranges, or machines with a
+         * single core, use std::sort.
+         * @param first Start of the range.
+         * @param last End of the range.
+         * @param cmp Strict weak ordering; called from several threads at once.
+         */
+        template<typename Iter, typename Compare>
+        void sort_range(Iter first, Iter last, Compare cmp) {
+            const size_t n = static_cast<size_t>(last - first);
+            if (n < PARALLEL_THRESHOLD) {
+                std::sort(first, last, cmp);
+                return;
+            }
+            sort_range(first, last, cmp,
+                std::min<size_t>(std::thread::hardware_concurrency(), n / (PARALLEL_THRESHOLD / 2)));
+        }
+
+        /**
+         * @brief Strict order shared by all engines: by value, then by insertion index.
+         * @param a First index.
+         * @param b Second index.
+         * @param keys The elements being ordered.
+         * @param descending True to order from largest to smallest.
+         * @return True if the element at a comes before the element at b.
+         */
+        template<typename T>
+        bool before(size_t a, size_t b, const std::pmr::vector<T>& keys, bool descending) {
+            if (descending) {
+                if (keys[b] < keys[a]) return true;
+                if (keys[a] < keys[b]) return false;
+            } else {
+                if (keys[a] < keys[b]) return true;
+                if (keys[b] < keys[a]) return false;
+            }
+            return a < b;
+        }
+
+        /**
+         * @brief Maps an element to an unsigned integer with the same ordering, for radix sorting.
+         * @details Only defined for integral types other than bool, and for IEEE float and double.
+         */
+        template<typename T, typename = void>
+        struct RadixKey {
+            static constexpr bool enabled = false;
+        };
+
+        template<typename T>
+        struct RadixKey<T, std::enable_if_t<std::is_integral<T>::value && !std::is_same<T, bool>::value>> {
+            static constexpr bool enabled = true;
+            using type = std::make_unsigned_t<T>;
+
+            static type get(T value) {
+                type bits = static_cast<type>(value);
+                if (std::is_signed<T>::value) {
+                    bits ^= type(1) << (sizeof(T) * 8 - 1); // Move negative values below positive ones
+                }
+                return bits;
+            }
+        };
+
+        template<typename T>
+        struct RadixKey<T, std::enable_if_t<std::is_floating_point<T>::value && std::numeric_limits<T>::is_iec559
+                                            && (sizeof(T) == 4 || sizeof(T) == 8)>> {
+            static constexpr bool enabled = true;
+            using type = std::conditional_t<sizeof(T) == 4, uint32_t, uint64_t>;
+
+            static type get(T value) {
+                if (value == 0) {
+                    value = 0; // -0.0 compares equal to 0.0, so it must get the same key
+                }
+                type bits;
+                std::memcpy(&bits, &value, sizeof(bits));
+                const type sign = type(1) << (sizeof(T) * 8 - 1);
+                // Negative values: flip all bits so larger magnitudes sort first.
+                // Positive values: set the sign bit so they sort after all negatives.
+                return (bits & sign) ? ~bits : (bits | sign);
+            }
+        };
+
+        /**
+         * @brief LSD radix sort of (key, index) pairs, one byte per pass.
+         * @details Stable, so equal keys keep their insertion order. Passes where every key has the
+         * same byte are skipped, which makes small-range data (e.g. ints below 65536) cheap.
+         * @tparam Index Unsigned type wide enough for every index.
+         * @param order Output permutation, resized to the number of elements.
+         * @param keys The elements to order.
+         * @param descending True to order from largest to smallest.
+         */
+        template<typename Index, typename T>
+        void radix_sort(std::pmr::vector<Index>& order, const std::pmr::vector<T>& keys, bool descending) {
+            using Key = typename RadixKey<T>::type;
+            struct Item {
+                Key key;
+                Index index;
+            };
+            constexpr size_t PASSES = sizeof(Key);
+
+            const size_t n = keys.size();
+            std::pmr::memory_resource* resource = order.get_allocator().resource();
+            std::pmr::vector<Item> items(n, resource), scratch(n, resource);
+            std::pmr::vector<std::array<size_t, 256>> counts(PASSES, resource);
+            for (auto& count : counts) {
+                count.fill(0);
+            }
+            for (size_t i = 0; i < n; ++i) {
+                Key key = RadixKey<T>::get(keys[i]);
+                if (descending) {
+                    key = static_cast<Key>(~key);
+                }
+                items[i] = Item{key, static_cast<Index>(i)};
+                for (size_t pass = 0; pass < PASSES; ++pass) {
+                    ++counts[pass][(key >> (pass * 8)) & 0xFF];
+                }
+            }
+
+            for (size_t pass = 0; pass < PASSES; ++pass) {
+                std::array<size_t, 256>& count = counts[pass];
+                if (count[(items[0].key >> (pass * 8)) & 0xFF] == n) {
+                    continue; // All keys share this byte
+                }
+                size_t offset = 0;
+                for (size_t& c : count) {
+                    size_t bucket = c;
+                    c = offset;
+                    offset += bucket;
+                }
+                for (const Item& item : items) {
+                    scratch[count[(item.key >> (pass * 8)) & 0xFF]++] = item;
+                }
+                items.swap(scratch);
+            }
+
+            order.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                order[i] = items[i].index;
+            }
+        }
+
+        constexpr size_t NETWORK_SIZE = 16; // Largest container sorted by the fixed sorting network
+        constexpr size_t NETWORK_MIN_SIZE = 8; // Below this std::sort beats the full 16-input network
+
+        /**
+         * @brief Puts the smaller of two values first, without branches.
+         */
+        inline void compare_exchange(uint64_t& a, uint64_t& b) {
+            // A mask instead of std::min/std::max, which compilers turn back into branches here
+            uint64_t swap = (a ^ b) & (uint64_t(0) - uint64_t(b < a));
+            a ^= swap;
+            b ^= swap;
+        }
+
+        /**
+         * @brief Comparator pairs of Batcher's odd-even merge sorting network over NETWORK_SIZE values.
+         */
+        struct Network {
+            static constexpr size_t PAIRS = 63; // Comparators Batcher's network needs for 16 inputs
+            size_t lo[PAIRS] = {};
+            size_t hi[PAIRS] = {};
+
+            constexpr Network() {
+                size_t count = 0;
+                for (size_t p = 1; p < NETWORK_SIZE; p *= 2) {
+                    for (size_t k = p; k > 0; k /= 2) {
+                        for (size_t j = k % p; j + k < NETWORK_SIZE; j += 2 * k) {
+                            for (size_t i = 0; i < k && i + j + k < NETWORK_SIZE; ++i) {
+                                if ((i + j) / (2 * p) == (i + j + k) / (2 * p)) {
+                                    lo[count] = i + j;
+                                    hi[count] = i + j + k;
+                                    ++count;
+                                }
+                            }
+                        }
+                    }
+                }
+            }
+        };
+
+        constexpr Network NETWORK{}; // Built at compile time
+
+        /**
+         * @brief Applies the comparators of NETWORK in order, each with constant indices.
+         * @param v The values to sort.
+         */
+        template<size_t... I>
+        inline void apply_network(uint64_t (&v)[NETWORK_SIZE], std::index_sequence<I...>) {
+            (compare_exchange(v[NETWORK.lo[I]], v[NETWORK.hi[I]]), ...);
+        }
+
+        /**
+         * @brief Sorts NETWORK_SIZE values with Batcher's odd-even merge sorting network.
+         * @details The comparator pairs are fixed at compile time and expanded into one
+         * compare-exchange each, so the sort is straight-line min/max code with no loops or
+         * data-dependent branches.
+         * @param v The values to sort, padded with UINT64_MAX up to NETWORK_SIZE.
+         */
+        inline void network_sort(uint64_t (&v)[NETWORK_SIZE]) {
+            apply_network(v, std::make_index_sequence<Network::PAIRS>());
+        }
+
+        /**
+         * @brief Sort for small containers of elements with a key of at most 32 bits.
+         * @details Each element becomes one 64-bit integer, key in the high half and index in the
+         * low half, so sorting plain integers sorts by value and then by insertion index.
+         * NETWORK_MIN_SIZE to NETWORK_SIZE elements go through the sorting network, other sizes
+         * through std::sort on the integers, with no comparator indirection in either case.
+         * Benchmarks/sort_bench.cpp compares the two.
+         * @tparam Index Unsigned type of the output indices.
+         * @param order Output permutation, resized to the number of elements.
+         * @param keys The elements to order, fewer than 2^32 of them.
+         * @param descending True to order from largest to smallest.
+         */
+        template<typename Index, typename T>
+        void packed_sort(std::pmr::vector<Index>& order, const std::pmr::vector<T>& keys, bool descending) {
+            using Key = typename RadixKey<T>::type;
+            const size_t n = keys.size();
+            auto pack = [&keys, descending](size_t i) {
+                Key key = RadixKey<T>::get(keys[i]);
+                if (descending) {
+                    key = static_cast<Key>(~key);
+                }
+                return (static_cast<uint64_t>(key) << 32) | i;
+            };
+
+            order.resize(n);
+            if (n >= NETWORK_MIN_SIZE && n <= NETWORK_SIZE) {
+                uint64_t v[NETWORK_SIZE];
+                for (size_t i = 0; i < NETWORK_SIZE; ++i) {
+                    v[i] = i < n ? pack(i) : std::numeric_limits<uint64_t>::max();
+                }
+                network_sort(v);
+                for (size_t i = 0; i < n; ++i) {
+                    order[i] = static_cast<Index>(static_cast<uint32_t>(v[i]));
+                }
+                return;
+            }
+
+            std::pmr::vector<uint64_t> packed(n, order.get_allocator().resource());
+            for (size_t i = 0; i < n; ++i) {
+                packed[i] = pack(i);
+            }
+            std::sort(packed.begin(), packed.end());
+            for (size_t i = 0; i < n; ++i) {
+                order[i] = static_cast<Index>(static_cast<uint32_t>(packed[i]));
+            }
+        }
+
+        /**
+         * @brief Comparison sort of packed (key, index) pairs.
+         * @details Comparing copies of the keys stored next to their indices keeps every comparison
+         * inside one contiguous buffer, instead of gathering data[a] and data[b] from all over the
+         * container. Only worth it for small trivially copyable keys.
+         * @tparam Index Unsigned type wide enough for every index.
+         * @param order Output permutation, resized to the number of elements.
+         * @param keys The elements to order.
+         * @param descending True to order from largest to smallest.
+         */
+        template<typename Index, typename T>
+        void pair_sort(std::pmr::vector<Index>& order, const std::pmr::vector<T>& keys, bool descending) {
+            struct Item {
+                T key;
+                Index index;
+            };
+            const size_t n = keys.size();
+            std::pmr::vector<Item> items(order.get_allocator().resource());
+            items.reserve(n);
+            for (size_t i = 0; i < n; ++i) {
+                items.push_back(Item{keys[i], static_cast<Index>(i)});
+            }
+            auto cmp = [descending](const Item& a, const Item& b) {
+                if (descending ? b.key < a.key : a.key < b.key) return true;
+                if (descending ? a.key < b.key : b.key < a.key) return false;
+                return a.index < b.index;
+            };
+            sort_range(items.begin(), items.end(), cmp);
+
+            order.resize(n);
+            for (size_t i = 0; i < n; ++i) {
+                order[i] = items[i].index;
+            }
+        }
+
+        /**
+         * @brief Sorts the indices of the given elements with the fastest engine for their type and count.
+         * @details Work buffers are allocated from the memory resource of order.
+         * @tparam Index Unsigned type wide enough for every index.
+         * @param order Output permutation, resized to the number of elements.
+         * @param keys The elements to order.
+         * @param descending True to order from largest to smallest.
+         */
+        template<typename Index, typename T>
+        void sort_indices(std::pmr::vector<Index>& order, const std::pmr::vector<T>& keys, bool descending) {
+            if constexpr (RadixKey<T>::enabled) {
+                if (keys.size() >= RADIX_THRESHOLD) {
+                    radix_sort(order, keys, descending);
+                    return;
+                }
+                if constexpr (sizeof(typename RadixKey<T>::type) <= 4) {
+                    packed_sort(order, keys, descending);
+                    return;
+                }
+            }
+            if constexpr (std::is_trivially_copyable<T>::value && sizeof(T) <= 16) {
+                pair_sort(order, keys, descending);
+                return;
+            }
+            order.resize(keys.size());
+            for (size_t i = 0; i < keys.size(); ++i) {
+                order[i] = static_cast<Index>(i);
+            }
+            sort_range(order.begin(), order.end(),
+                [&keys, descending](Index a, Index b) {
+                    return before(a, b, keys, descending);
+                });
+        }
+
+    } // namespace IndexSort
+
+} // namespace Container
+
+#endif
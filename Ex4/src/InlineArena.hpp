@@ -0,0 +1,94 @@
+// Email: shanig7531@gmail.com
+
+#ifndef INLINE_ARENA_HPP
+#define INLINE_ARENA_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+namespace Container {
+
+    /**
+     * @brief Memory resource that hands out memory from a fixed buffer stored inside the object.
+     *
+     * @details
+     * Allocation bumps a pointer through the buffer. Freeing the most recent block rewinds the
+     * pointer (LIFO), and once every block is freed the whole buffer is reused from the start.
+     * Requests that do not fit go to the upstream resource.
+     * The arena is tied to its address, so it can be neither copied nor moved.
+     *
+     * @tparam Bytes Size of the inline buffer.
+     */
+    template<size_t Bytes>
+    class InlineArena : public std::pmr::memory_resource {
+
+    private:
+        alignas(std::max_align_t) std::byte buffer[Bytes]; // Inline storage
+        size_t top = 0; // Offset of the first free byte in buffer
+        size_t live = 0; // Blocks handed out from buffer and not freed yet
+        std::pmr::memory_resource* upstream; // Serves requests that do not fit
+
+        /**
+         * @brief Checks whether a block was handed out from the inline buffer.
+         * @param p The block.
+         * @return True if p points into buffer.
+         */
+        bool owns(const void* p) const {
+            auto address = reinterpret_cast<std::uintptr_t>(p);
+            auto begin = reinterpret_cast<std::uintptr_t>(buffer);
+            return address >= begin && address < begin + Bytes;
+        }
+
+    protected:
+        void* do_allocate(size_t bytes, size_t alignment) override {
+            size_t start = (top + alignment - 1) / alignment * alignment;
+            if (alignment <= alignof(std::max_align_t) && start <= Bytes && bytes <= Bytes - start) {
+                top = start + bytes;
+                ++live;
+                return buffer + start;
+            }
+            return upstream->allocate(bytes, alignment);
+        }
+
+        void do_deallocate(void* p, size_t bytes, size_t alignment) override {
+            if (!owns(p)) {
+                upstream->deallocate(p, bytes, alignment);
+                return;
+            }
+            size_t offset = static_cast<size_t>(static_cast<std::byte*>(p) - buffer);
+            if (offset + bytes == top) {
+                top = offset; // Freed the most recent block
+            }
+            if (--live == 0) {
+                top = 0;
+            }
+        }
+
+        bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override {
+            return this == &other;
+        }
+
+    public:
+        /**
+         * @brief Creates an empty arena.
+         * @param up Resource for requests the buffer cannot serve.
+         */
+        explicit InlineArena(std::pmr::memory_resource* up = std::pmr::get_default_resource())
+            : upstream(up) {}
+
+        InlineArena(const InlineArena&) = delete;
+        InlineArena& operator=(const InlineArena&) = delete;
+
+        /**
+         * @brief Returns the number of bytes of the inline buffer currently in use.
+         * @return Offset of the first free byte.
+         */
+        size_t used() const {
+            return top;
+        }
+    };
+
+} // namespace Container
+
+#endif
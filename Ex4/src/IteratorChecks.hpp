@@ -0,0 +1,47 @@
+// Email: shanig7531@gmail.com
+
+#ifndef ITERATOR_CHECKS_HPP
+#define ITERATOR_CHECKS_HPP
+
+/**
+ * @brief Keeps a function out of line, for slow paths that would otherwise bloat the hot loops that call them.
+ */
+#if defined(__GNUC__) || defined(__clang__)
+#define CONTAINER_NOINLINE __attribute__((noinline))
+#elif defined(_MSC_VER)
+#define CONTAINER_NOINLINE __declspec(noinline)
+#else
+#define CONTAINER_NOINLINE
+#endif
+
+namespace Container {
+
+    /**
+     * @brief Bounds policy that makes iterators throw std::out_of_range on misuse.
+     */
+    struct Checked {
+        static constexpr bool enabled = true;
+    };
+
+    /**
+     * @brief Bounds policy that removes the iterator checks entirely.
+     * @details Misuse is undefined behaviour, as with raw pointers, but every operation inlines
+     * to plain index arithmetic, so hot loops can be vectorized.
+     */
+    struct Unchecked {
+        static constexpr bool enabled = false;
+    };
+
+    /**
+     * @brief Bounds policy used when none is given.
+     * @details Debug builds and the tests keep the throwing checks, release builds (NDEBUG) drop them.
+     */
+#ifdef NDEBUG
+    using DefaultBounds = Unchecked;
+#else
+    using DefaultBounds = Checked;
+#endif
+
+} // namespace Container
+
+#endif
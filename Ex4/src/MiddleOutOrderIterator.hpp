@@ -3,8 +3,10 @@
 #ifndef MIDDLE_OUT_ORDER_ITERATOR_HPP
 #define MIDDLE_OUT_ORDER_ITERATOR_HPP
 
-#include <vector>
 #include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include "IteratorChecks.hpp"
 
 namespace Container {
 
@@ -16,54 +18,81 @@ namespace Container {
      * @details Starts from middle element, then alternates between left and right elements.
      * For odd-sized containers, middle element is floor(size/2).
      * @tparam T The type of elements stored in the container.
+     * @tparam Bounds Checked to throw std::out_of_range on misuse, Unchecked to drop the checks.
      */
-    template<typename T>
+    template<typename T, typename Bounds = DefaultBounds>
     class MiddleOutOrderIterator {
 
     private:
-        const MyContainer<T>& container; // Reference to the container being iterated
-        std::vector<size_t> indices; // Indices in middle-out order
-        size_t pos; // Current position in indices vector
+        const MyContainer<T>* container; // Container being iterated (a pointer, so iterators are assignable)
+        size_t pos; // Current position in middle-out order
 
         /**
-         * @brief Builds the indices vector for middle-out traversal order.
+         * @brief Maps a middle-out position to an index in the container.
+         * @details The order only depends on the size: mid, mid-1, mid+1, mid-2, mid+2, ...
+         * The left side never has fewer elements than the right one, so the sequence ends on
+         * the left when the size is even.
+         * @param p Position in middle-out order.
+         * @return Index of the element at that position.
          */
-        void build_indices() {
-            size_t n = container.size();
-            indices.resize(n);
-            
-            if (n == 0) return;
-
-            // Start from middle - for odd n, take floor(n/2)
-            size_t mid = n / 2;
-            size_t left = mid - 1;
-            size_t right = mid + 1;
-            size_t idx = 0;
-
-            // Add middle element first
-            indices[idx++] = mid;
+        size_t element_index(size_t p) const {
+            size_t mid = container->data.size() / 2;
+            size_t step = (p + 1) / 2;
+            return p % 2 == 1 ? mid - step : mid + step;
+        }
 
-            // Alternate between left and right elements
-            while (idx < n) {
-                if (left != static_cast<size_t>(-1)) {
-                    indices[idx++] = left--;
+        /**
+         * @brief Returns the first position from p on whose element was not removed.
+         * @details Positions count the slots of data, so an iterator held across a deferred remove
+         * keeps its place and steps over the tombstones. begin_*() and end_*() compact them, so
+         * iterators taken afterwards never meet one.
+         * @param p Position in middle-out order.
+         * @return The first live position from p on, or the end position.
+         */
+        size_t live(size_t p) const {
+            if (container->has_tombstones()) {
+                while (p < container->data.size() && container->is_dead(element_index(p))) {
+                    ++p;
                 }
-                if (idx < n && right < n) {
-                    indices[idx++] = right++;
+            }
+            return p;
+        }
+
+        /**
+         * @brief Counts the live elements at positions [first, last).
+         * @param first First position.
+         * @param last One past the last position.
+         * @return The number of elements in the range that were not removed.
+         */
+        std::ptrdiff_t live_between(size_t first, size_t last) const {
+            std::ptrdiff_t count = 0;
+            for (size_t p = first; p < last; ++p) {
+                if (!container->is_dead(element_index(p))) {
+                    ++count;
                 }
             }
+            return count;
         }
 
     public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        /**
+         * @brief Default constructor. Creates a singular iterator that may only be assigned to or compared.
+         */
+        MiddleOutOrderIterator() : container(nullptr), pos(0) {}
+
         /**
          * @brief Constructor for the MiddleOutOrderIterator.
          * @param cont Reference to the container.
          * @param start_pos The starting position for the iterator (default is 0).
          */
         MiddleOutOrderIterator(const MyContainer<T>& cont, size_t start_pos = 0)
-            : container(cont), pos(start_pos) {
-            build_indices();
-        }
+            : container(&cont), pos(start_pos) {}
 
         /**
          * @brief Dereference operator.
@@ -71,10 +100,30 @@ namespace Container {
          * @throw std::out_of_range If iterator is out of bounds
          */
         const T& operator*() const {
-            if (pos >= container.size()) {
+            size_t p = live(pos);
+            if (Bounds::enabled && p >= container->data.size()) {
                 throw std::out_of_range("Iterator out of bounds");
             }
-            return container.data[indices[pos]];
+            return container->data[element_index(p)];
+        }
+
+        /**
+         * @brief Member access operator.
+         * @return Pointer to the current element in the container.
+         * @throw std::out_of_range If iterator is out of bounds
+         */
+        const T* operator->() const {
+            return &**this;
+        }
+
+        /**
+         * @brief Subscript operator.
+         * @param n Offset from the current position.
+         * @return Reference to the element n positions away.
+         * @throw std::out_of_range If the position is out of bounds
+         */
+        const T& operator[](difference_type n) const {
+            return *(*this + n);
         }
 
         /**
@@ -83,10 +132,11 @@ namespace Container {
          * @throw std::out_of_range If incrementing past the end
          */
         MiddleOutOrderIterator& operator++() {
-            if (pos >= container.size()) {
+            size_t p = live(pos);
+            if (Bounds::enabled && p >= container->data.size()) {
                 throw std::out_of_range("Cannot increment iterator past end");
             }
-            ++pos;
+            pos = p + 1;
             return *this;
         }
 
@@ -96,21 +146,125 @@ namespace Container {
          * @throw std::out_of_range If incrementing past the end
          */
         MiddleOutOrderIterator operator++(int) {
-            if (pos >= container.size()) {
-                throw std::out_of_range("Cannot increment iterator past end");
-            }
             MiddleOutOrderIterator temp = *this;
-            ++pos;
+            ++*this;
+            return temp;
+        }
+
+        /**
+         * @brief Pre-decrement operator.
+         * @return Reference to the iterator after decrement.
+         * @throw std::out_of_range If decrementing before the beginning
+         */
+        MiddleOutOrderIterator& operator--() {
+            size_t p = pos;
+            do {
+                if (Bounds::enabled && p == 0) {
+                    throw std::out_of_range("Cannot decrement iterator before begin");
+                }
+                --p;
+            } while (container->has_tombstones() && container->is_dead(element_index(p)));
+            pos = p;
+            return *this;
+        }
+
+        /**
+         * @brief Post-decrement operator.
+         * @return Copy of iterator before decrement.
+         * @throw std::out_of_range If decrementing before the beginning
+         */
+        MiddleOutOrderIterator operator--(int) {
+            MiddleOutOrderIterator temp = *this;
+            --*this;
             return temp;
         }
 
+        /**
+         * @brief Moves the iterator by n positions.
+         * @param n Number of positions, negative to move backwards.
+         * @return Reference to the moved iterator.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        MiddleOutOrderIterator& operator+=(difference_type n) {
+            if (container->has_tombstones()) {
+                for (; n > 0; --n) {
+                    ++*this;
+                }
+                for (; n < 0; ++n) {
+                    --*this;
+                }
+                return *this;
+            }
+            difference_type target = static_cast<difference_type>(pos) + n;
+            if (Bounds::enabled && (target < 0 || static_cast<size_t>(target) > container->data.size())) {
+                throw std::out_of_range("Cannot move iterator out of bounds");
+            }
+            pos = static_cast<size_t>(target);
+            return *this;
+        }
+
+        /**
+         * @brief Moves the iterator back by n positions.
+         * @param n Number of positions, negative to move forwards.
+         * @return Reference to the moved iterator.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        MiddleOutOrderIterator& operator-=(difference_type n) {
+            return *this += -n;
+        }
+
+        /**
+         * @brief Returns an iterator n positions ahead.
+         * @param n Number of positions, negative to move backwards.
+         * @return The moved copy.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        MiddleOutOrderIterator operator+(difference_type n) const {
+            MiddleOutOrderIterator temp = *this;
+            return temp += n;
+        }
+
+        /**
+         * @brief Returns an iterator n positions ahead.
+         * @param n Number of positions, negative to move backwards.
+         * @param it The iterator to move.
+         * @return The moved copy.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        friend MiddleOutOrderIterator operator+(difference_type n, const MiddleOutOrderIterator& it) {
+            return it + n;
+        }
+
+        /**
+         * @brief Returns an iterator n positions back.
+         * @param n Number of positions, negative to move forwards.
+         * @return The moved copy.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        MiddleOutOrderIterator operator-(difference_type n) const {
+            MiddleOutOrderIterator temp = *this;
+            return temp -= n;
+        }
+
+        /**
+         * @brief Distance between two iterators over the same container.
+         * @param other The iterator to measure from.
+         * @return Number of increments needed to get from other to this iterator.
+         */
+        difference_type operator-(const MiddleOutOrderIterator& other) const {
+            if (container->has_tombstones()) {
+                return pos >= other.pos ? live_between(other.pos, pos) : -live_between(pos, other.pos);
+            }
+            return static_cast<difference_type>(pos) - static_cast<difference_type>(other.pos);
+        }
+
         /**
          * @brief Equality comparison operator.
          * @param other Another iterator to compare.
          * @return True if both iterators are at the same position and container.
          */
         bool operator==(const MiddleOutOrderIterator& other) const {
-            return pos == other.pos && &container == &other.container;
+            return pos == other.pos && container == other.container;
         }
 
         /**
@@ -121,6 +275,42 @@ namespace Container {
         bool operator!=(const MiddleOutOrderIterator& other) const {
             return !(*this == other);
         }
+
+        /**
+         * @brief Less-than comparison operator.
+         * @param other Another iterator over the same container.
+         * @return True if this iterator is before other.
+         */
+        bool operator<(const MiddleOutOrderIterator& other) const {
+            return pos < other.pos;
+        }
+
+        /**
+         * @brief Greater-than comparison operator.
+         * @param other Another iterator over the same container.
+         * @return True if this iterator is after other.
+         */
+        bool operator>(const MiddleOutOrderIterator& other) const {
+            return other < *this;
+        }
+
+        /**
+         * @brief Less-than-or-equal comparison operator.
+         * @param other Another iterator over the same container.
+         * @return True if this iterator is not after other.
+         */
+        bool operator<=(const MiddleOutOrderIterator& other) const {
+            return !(other < *this);
+        }
+
+        /**
+         * @brief Greater-than-or-equal comparison operator.
+         * @param other Another iterator over the same container.
+         * @return True if this iterator is not before other.
+         */
+        bool operator>=(const MiddleOutOrderIterator& other) const {
+            return !(*this < other);
+        }
     };
 
 } // namespace Container
@@ -4,10 +4,24 @@
 #define MYCONTAINER_HPP
 
 #include <vector>
+#include <memory_resource>
+#include <memory>
+#include <unordered_set>
+#include <unordered_map>
+#include <optional>
+#include <mutex>
+#include <type_traits>
+#include <iterator>
+#include <utility>
+#include <initializer_list>
 #include <algorithm>
 #include <iostream>
 #include <stdexcept>
 
+#include "SortedIndex.hpp"
+#include "SharedStorage.hpp"
+#include "IteratorChecks.hpp"
+#include "ValueTraits.hpp"
 #include "AscendingOrderIterator.hpp"
 #include "DescendingOrderIterator.hpp"
 #include "SideCrossOrderIterator.hpp"
@@ -17,6 +31,9 @@
 
 namespace Container{
 
+    template<typename T>
+    class Snapshot;
+
     /**
      * @brief Template class for a generic container that holds comparable elements.
      * 
@@ -24,6 +41,10 @@ namespace Container{
      * Provides basic operations like add, remove, and size.
      * All implementations are in this header file because this is a template class.
      * In C++, template implementations must be in the header file so the compiler can generate code for each type.
+     * Const members may be called from several threads at once: the sorted permutations they build
+     * on first use are built under a lock. This holds while no thread modifies the container and
+     * no deferred removals are pending, since begin_*() and end_*() compact those; call compact()
+     * before sharing a container that uses set_deferred_remove(true).
      * 
      * @tparam T The type of elements stored in the container. Default is int.
      */
@@ -31,12 +52,697 @@ namespace Container{
     class MyContainer{
 
     private:
-        std::vector<T> data;// Internal storage for the container elements
+        // Members that compaction touches are mutable: pending tombstones are compacted by begin_*()
+        // and end_*(), which are const. Compaction never changes the observable contents.
+        // Copies and snapshots share the elements until one side writes to them (copy-on-write)
+        mutable SharedStorage<T> data;// Internal storage for the container elements
+        mutable size_t version = 0; // Bumped on every mutation, used to stamp the cached indices
+
+        static constexpr size_t NPOS = static_cast<size_t>(-1); // Marks a cache that was never built or a removed index
+
+        // Permutations are immutable once built and shared with the iterators, so copying an iterator
+        // only bumps a reference count. A rebuild allocates a new buffer instead of touching the old one.
+        mutable std::shared_ptr<SortedIndex<T>> asc_cache; // Cached permutation of data in ascending order
+        mutable size_t asc_version = NPOS; // Version asc_cache was built for
+        mutable std::shared_ptr<SortedIndex<T>> desc_cache; // Cached permutation of data in descending order
+        mutable size_t desc_version = NPOS; // Version desc_cache was built for
+        mutable std::mutex cache_mutex; // Lets concurrent const reads build the caches above once
+
+        bool incremental_sort = false; // Keep the cached permutations up to date on add/remove
+        bool lazy_sort = false; // Build new permutations as heaps and sort only the positions that are read
+        bool deferred_remove = false; // Mark removed slots as tombstones instead of compacting data
+        bool pinned = false; // The memory resource lives inside this object, so a move cannot take it along
+
+        /**
+         * @brief Record of one removal that changed the container, used to follow elements across the renumbering.
+         * @details add() needs no record: it appends, so the indices of existing elements never change.
+         * Only the indices are kept, so removed elements are destroyed right away.
+         */
+        struct Removal {
+            size_t version; // Container version the removal produced
+            std::vector<size_t> indices; // Indices the removed elements had, in increasing order
+        };
+
+        static constexpr size_t MAX_LOGGED_REMOVALS = 64; // Older removals are forgotten; iterators further behind move to the end
+
+        mutable size_t log_start = 0; // Every removal that produced a later version is in the removal log
+
+        struct NoPositions {}; // Stand-in for the value index when T has no std::hash
+
+        /**
+         * @brief Value index type: each distinct value maps to its indices in data, in increasing order.
+         */
+        using PositionIndex = std::conditional_t<is_hashable<T>::value,
+            std::pmr::unordered_map<T, std::pmr::vector<size_t>>, NoPositions>;
+
+        static constexpr size_t COMPACT_FRACTION = 4; // Compact once more than 1/4 of the slots are dead
+
+        /**
+         * @brief State that only some containers need: the value index, the tombstones and the removal log.
+         * @details Kept behind one pointer and allocated from the memory resource on first use, so a
+         * container that never removes elements, defers removals or indexes values stays small.
+         */
+        struct Extras {
+            std::optional<PositionIndex> positions; // Value index, present while set_value_index(true)
+            std::pmr::vector<bool> dead; // Tombstones: removed slots not compacted yet
+            size_t dead_count = 0; // Number of tombstones set in dead
+            // A vector rather than a deque: an empty std::deque already allocates, and the log is short
+            std::vector<Removal> removals; // Recent removals, oldest first, kept while sorted caches exist
+
+            explicit Extras(std::pmr::memory_resource* resource) : dead(resource) {}
+
+            Extras(const Extras& other, std::pmr::memory_resource* resource)
+                : dead(other.dead, resource), dead_count(other.dead_count), removals(other.removals) {
+                if constexpr (is_hashable<T>::value) {
+                    if (other.positions) {
+                        positions.emplace(*other.positions, resource);
+                    }
+                }
+            }
+        };
+
+        /**
+         * @brief Destroys an Extras and returns its memory to the resource it came from.
+         */
+        struct ExtrasDeleter {
+            void operator()(Extras* extras) const {
+                std::pmr::memory_resource* memory = extras->dead.get_allocator().resource(); // Where extras came from
+                extras->~Extras();
+                std::pmr::polymorphic_allocator<Extras>(memory).deallocate(extras, 1);
+            }
+        };
+
+        mutable std::unique_ptr<Extras, ExtrasDeleter> extras; // Null until the state above is first needed
+
+        /**
+         * @brief Maps an element index across one removal.
+         * @param index Index of the element before the removal.
+         * @param removed Indices removed, in increasing order.
+         * @return Index of the element after the removal, or NPOS if it was removed.
+         */
+        static size_t renumber(size_t index, const std::vector<size_t>& removed) {
+            auto it = std::lower_bound(removed.begin(), removed.end(), index);
+            if (it != removed.end() && *it == index) {
+                return NPOS;
+            }
+            return index - static_cast<size_t>(it - removed.begin());
+        }
+
+        /**
+         * @brief Applies one removal to a permutation: drops the removed indices and renumbers the rest.
+         * @details Removing elements keeps the relative order of the others, so no comparisons are needed.
+         * @param order The permutation to update.
+         * @param removed Indices removed, in increasing order.
+         */
+        template<typename Index>
+        static void erase_removed(std::pmr::vector<Index>& order, const std::vector<size_t>& removed) {
+            size_t kept = 0;
+            for (Index i : order) {
+                size_t next = renumber(i, removed);
+                if (next != NPOS) {
+                    order[kept++] = static_cast<Index>(next);
+                }
+            }
+            order.resize(kept);
+        }
+
+        /**
+         * @brief Allocates a shared sorted index, control block included, from the container's memory resource.
+         * @param args Arguments forwarded to the SortedIndex constructor.
+         * @return The new index.
+         */
+        template<typename... Args>
+        std::shared_ptr<SortedIndex<T>> make_index(Args&&... args) const {
+            return std::allocate_shared<SortedIndex<T>>(
+                std::pmr::polymorphic_allocator<SortedIndex<T>>(resource()), std::forward<Args>(args)...);
+        }
+
+        /**
+         * @brief Allocates the value index, tombstones and removal log from the memory resource.
+         * @param args Arguments for the Extras constructor after the resource.
+         * @return Owning pointer to the new Extras.
+         */
+        template<typename... Args>
+        std::unique_ptr<Extras, ExtrasDeleter> make_extras(const Args&... args) const {
+            std::pmr::polymorphic_allocator<Extras> alloc(resource());
+            Extras* created = alloc.allocate(1);
+            try {
+                ::new (static_cast<void*>(created)) Extras(args..., resource());
+            } catch (...) {
+                alloc.deallocate(created, 1);
+                throw;
+            }
+            return std::unique_ptr<Extras, ExtrasDeleter>(created);
+        }
+
+        /**
+         * @brief Returns the value index, tombstones and removal log, allocating them on first use.
+         * @return The container's Extras.
+         */
+        Extras& extra() const {
+            if (!extras) {
+                extras = make_extras();
+            }
+            return *extras;
+        }
+
+        /**
+         * @brief Returns the value index.
+         * @return The index, or nullptr while set_value_index(true) is off.
+         */
+        PositionIndex* value_index() const {
+            return extras && extras->positions ? &*extras->positions : nullptr;
+        }
+
+        /**
+         * @brief Returns the log of recent removals, oldest first.
+         * @return The log; empty if nothing was logged.
+         */
+        const std::vector<Removal>& removal_log() const {
+            static const std::vector<Removal> none;
+            return extras ? extras->removals : none;
+        }
+
+        /**
+         * @brief Copies everything but the elements from another container.
+         * @details The cached permutations live in the other container's memory resource, so they are
+         * shared only if this container allocates from an equal one; otherwise they are rebuilt on
+         * the next sorted read. The value index and tombstones are copied into this container's resource.
+         * @param other The container to copy from.
+         */
+        void copy_state(const MyContainer& other) {
+            version = other.version;
+            incremental_sort = other.incremental_sort;
+            lazy_sort = other.lazy_sort;
+            deferred_remove = other.deferred_remove;
+            log_start = other.log_start;
+            if (resource()->is_equal(*other.resource())) {
+                asc_cache = other.asc_cache;
+                asc_version = other.asc_version;
+                desc_cache = other.desc_cache;
+                desc_version = other.desc_version;
+            } else {
+                asc_cache.reset();
+                asc_version = NPOS;
+                desc_cache.reset();
+                desc_version = NPOS;
+            }
+            extras.reset();
+            if (other.extras) {
+                extras = make_extras(*other.extras);
+            }
+        }
+
+        /**
+         * @brief Leaves a moved-from container empty, with its settings and memory resource kept.
+         * @details The version moves on, so iterators still pointing here see a changed container.
+         */
+        void clear_moved_from() noexcept {
+            data.clear();
+            ++version;
+            asc_cache.reset();
+            asc_version = NPOS;
+            desc_cache.reset();
+            desc_version = NPOS;
+            log_start = version;
+            if (extras) {
+                extras->removals.clear();
+                if constexpr (is_hashable<T>::value) {
+                    if (extras->positions) {
+                        extras->positions->clear();
+                    }
+                }
+                extras->dead.clear();
+                extras->dead_count = 0;
+            }
+        }
+
+        /**
+         * @brief Takes over the contents of a container on an unequal memory resource.
+         * @details The buffers cannot change hands, so the elements are moved one by one into this
+         * container's resource. The caller leaves other empty afterwards.
+         * @param other The container to move from.
+         */
+        void move_across(MyContainer& other) {
+            size_t newer = std::max(version, other.version) + 1;
+            data.take(other.data);
+            copy_state(other);
+            restamp(newer);
+        }
+
+        /**
+         * @brief Moves the version past a given one after the contents were replaced wholesale.
+         * @details Versions are counted per container, so contents taken over from another container
+         * may carry a version this one already had. Stamping a newer one makes iterators over this
+         * container notice the change, and emptying the log makes them reset instead of following
+         * removals that never happened here. Cached permutations stay valid if they were current.
+         * @param newer The new version, greater than every version either container had.
+         */
+        void restamp(size_t newer) noexcept {
+            if (asc_version == version) {
+                asc_version = newer;
+            } else {
+                asc_cache.reset();
+                asc_version = NPOS;
+            }
+            if (desc_version == version) {
+                desc_version = newer;
+            } else {
+                desc_cache.reset();
+                desc_version = NPOS;
+            }
+            version = newer;
+            if (extras) {
+                extras->removals.clear();
+            }
+            log_start = version;
+        }
+
+        /**
+         * @brief Gives write access to a cached permutation, copying it first if an iterator still shares it.
+         * @details A lazy permutation is sorted completely first, so this must run before data changes.
+         * A 32-bit permutation is widened once data outgrows it.
+         * @param index The cached permutation to modify.
+         * @return Reference to an index owned only by the container.
+         */
+        SortedIndex<T>& writable(std::shared_ptr<SortedIndex<T>>& index) const {
+            if (index.use_count() > 1) {
+                index = make_index(*index);
+            }
+            if (!SortedIndex<T>::fits_narrow(data.size())) {
+                index->widen(data);
+            }
+            return *index;
+        }
+
+        /**
+         * @brief Inserts the last element of data into the cached permutations that are still current.
+         * @details Called by add() before the version is bumped. Each insert is a binary search plus a
+         * shift of the index buffer, with no comparisons beyond O(log n). The new element has the
+         * highest index, so placing it after its equals keeps the order stable.
+         */
+        void insert_sorted() {
+            size_t index = data.size() - 1;
+            const T& value = data[index];
+            if (asc_version == version) {
+                writable(asc_cache).visit([this, index, &value](auto& perm) {
+                    auto& order = perm.indices(data);
+                    auto at = std::upper_bound(order.begin(), order.end(), value,
+                        [this](const T& v, size_t i) {
+                            return v < data[i];
+                        });
+                    order.insert(at, static_cast<typename std::decay_t<decltype(perm)>::index_type>(index));
+                });
+                asc_version = version + 1;
+            }
+            if (desc_version == version) {
+                writable(desc_cache).visit([this, index, &value](auto& perm) {
+                    auto& order = perm.indices(data);
+                    auto at = std::upper_bound(order.begin(), order.end(), value,
+                        [this](const T& v, size_t i) {
+                            return data[i] < v;
+                        });
+                    order.insert(at, static_cast<typename std::decay_t<decltype(perm)>::index_type>(index));
+                });
+                desc_version = version + 1;
+            }
+        }
+
+        /**
+         * @brief Finishes an add() of one element appended to data.
+         */
+        void appended() {
+            index_positions(data.size() - 1);
+            if (incremental_sort) {
+                insert_sorted();
+            }
+            ++version;
+        }
+
+        /**
+         * @brief Adds the elements from a given index to the end of data to the value index, if it is on.
+         * @param from Index of the first element to add.
+         */
+        void index_positions(size_t from) {
+            if constexpr (is_hashable<T>::value) {
+                if (PositionIndex* positions = value_index()) {
+                    for (size_t i = from; i < data.size(); ++i) {
+                        (*positions)[data[i]].push_back(i);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Updates the value index for a removal: drops the removed indices and renumbers the rest.
+         * @param removed Indices removed, in increasing order.
+         */
+        void erase_positions(const std::vector<size_t>& removed) const {
+            if constexpr (is_hashable<T>::value) {
+                PositionIndex* positions = value_index();
+                if (!positions) {
+                    return;
+                }
+                for (auto it = positions->begin(); it != positions->end();) {
+                    std::pmr::vector<size_t>& at = it->second;
+                    if (at.back() < removed.front()) {
+                        ++it; // Nothing before these positions moves
+                        continue;
+                    }
+                    erase_removed(at, removed);
+                    it = at.empty() ? positions->erase(it) : std::next(it);
+                }
+            }
+        }
+
+        /**
+         * @brief Removes the elements at the given indices, or marks them as tombstones in deferred mode.
+         * @param removed Indices of live elements to remove, in increasing order.
+         * @return The number of elements removed.
+         */
+        size_t erase_indices(std::vector<size_t> removed) {
+            if (removed.empty()) {
+                return 0;
+            }
+            if (!deferred_remove) {
+                return erase_now(std::move(removed));
+            }
+
+            unindex_positions(removed);
+            Extras& side = extra();
+            if (side.dead.size() < data.size()) {
+                side.dead.resize(data.size(), false);
+            }
+            for (size_t i : removed) {
+                side.dead[i] = true;
+            }
+            side.dead_count += removed.size();
+            // The elements stay where they are, so permutations that were current still are
+            if (asc_version == version) {
+                ++asc_version;
+            }
+            if (desc_version == version) {
+                ++desc_version;
+            }
+            ++version; // Sorted iterators catch up, and so compact, on their next dereference
+            if (side.dead_count * COMPACT_FRACTION > data.size()) {
+                settle();
+            }
+            return removed.size();
+        }
+
+        /**
+         * @brief Checks whether a slot of data holds a removed element waiting for compaction.
+         * @param index The slot.
+         * @return True if the slot is a tombstone.
+         */
+        bool is_dead(size_t index) const {
+            return extras && index < extras->dead.size() && extras->dead[index];
+        }
+
+        /**
+         * @brief Checks whether any slot of data holds a removed element waiting for compaction.
+         * @return True if there are tombstones.
+         */
+        bool has_tombstones() const {
+            return extras && extras->dead_count != 0;
+        }
+
+        /**
+         * @brief Drops tombstoned elements from the value index right away, so lookups stop finding them.
+         * @param removed Indices of the tombstoned elements, in increasing order.
+         */
+        void unindex_positions(const std::vector<size_t>& removed) {
+            if constexpr (is_hashable<T>::value) {
+                PositionIndex* positions = value_index();
+                if (!positions) {
+                    return;
+                }
+                for (size_t i : removed) {
+                    auto it = positions->find(data[i]);
+                    std::pmr::vector<size_t>& at = it->second;
+                    at.erase(std::lower_bound(at.begin(), at.end(), i));
+                    if (at.empty()) {
+                        positions->erase(it);
+                    }
+                }
+            }
+        }
+
+        /**
+         * @brief Compacts pending tombstones, if there are any.
+         * @details Called by the mutators, compact(), the begin_*()/end_*() accessors and sorted
+         * iterators catching up after a remove; plain reads skip tombstones instead. Compaction goes through the normal removal path, so the sorted
+         * permutations and the value index are renumbered, not rebuilt, and live sorted iterators follow.
+         */
+        void settle() const {
+            if (!has_tombstones()) {
+                return;
+            }
+            std::vector<size_t> removed;
+            removed.reserve(extras->dead_count);
+            for (size_t i = 0; i < extras->dead.size(); ++i) {
+                if (extras->dead[i]) {
+                    removed.push_back(i);
+                }
+            }
+            extras->dead.clear();
+            extras->dead_count = 0;
+            erase_now(std::move(removed));
+        }
+
+        /**
+         * @brief Removes the elements at the given indices from data, keeping the others in insertion order.
+         * @details Updates the sorted permutations, the value index and the removal log.
+         * @param removed Indices to remove, in increasing order.
+         * @return The number of elements removed.
+         */
+        size_t erase_now(std::vector<size_t> removed) const {
+            if (incremental_sort) {
+                erase_sorted(removed);
+            }
+            erase_positions(removed);
+
+            // Sorted caches and the iterators sharing them need to know which elements disappear
+            const bool tracked = asc_cache || desc_cache;
+            auto& elements = data.write();
+            size_t kept = removed.front();
+            auto next = removed.begin();
+            for (size_t i = removed.front(); i < elements.size(); ++i) {
+                if (next != removed.end() && *next == i) {
+                    ++next;
+                } else {
+                    elements[kept++] = std::move(elements[i]);
+                }
+            }
+            elements.erase(elements.begin() + static_cast<std::ptrdiff_t>(kept), elements.end());
+            ++version;
+
+            size_t removed_count = removed.size();
+            if (tracked) {
+                std::vector<Removal>& removals = extra().removals;
+                removals.push_back(Removal{version, std::move(removed)});
+                if (removals.size() > MAX_LOGGED_REMOVALS) {
+                    log_start = removals.front().version;
+                    removals.erase(removals.begin());
+                }
+            } else {
+                log_start = version;
+            }
+            return removed_count;
+        }
+
+        /**
+         * @brief Drops removed elements from the cached permutations that are still current.
+         * @details Called by remove() before data changes.
+         * @param removed Indices of the elements being removed, in increasing order.
+         */
+        void erase_sorted(const std::vector<size_t>& removed) const {
+            auto erase = [this, &removed](auto& perm) {
+                erase_removed(perm.indices(data), removed);
+            };
+            if (asc_version == version) {
+                writable(asc_cache).visit(erase);
+                asc_version = version + 1;
+            }
+            if (desc_version == version) {
+                writable(desc_cache).visit(erase);
+                desc_version = version + 1;
+            }
+        }
+
+        /**
+         * @brief Brings an outdated ascending permutation up to date without sorting it again.
+         * @details Replays the logged removals on a copy of the old permutation, then sorts only the
+         * elements added since and merges them in: O(n + k log k) for k new elements.
+         * The caller checks that the old permutation is complete and the log covers it.
+         */
+        void patch_ascending() const {
+            asc_cache = asc_cache->visit([this](const auto& perm) {
+                using Index = typename std::decay_t<decltype(perm)>::index_type;
+                std::pmr::memory_resource* resource = data.resource();
+                std::pmr::vector<Index> order(perm.complete(data), resource); // Complete already, so data is not read
+                for (const Removal& removal : removal_log()) {
+                    if (removal.version > asc_version) {
+                        erase_removed(order, removal.indices);
+                    }
+                }
+
+                std::pmr::vector<bool> present(data.size(), false, resource);
+                for (Index i : order) {
+                    present[i] = true;
+                }
+                std::pmr::vector<Index> added(resource);
+                for (size_t i = 0; i < data.size(); ++i) {
+                    if (!present[i]) {
+                        added.push_back(static_cast<Index>(i));
+                    }
+                }
+                auto before = [this](Index a, Index b) {
+                    return IndexSort::before(a, b, data.get(), false);
+                };
+                std::sort(added.begin(), added.end(), before);
+
+                std::pmr::vector<Index> merged(resource);
+                merged.reserve(data.size());
+                std::merge(order.begin(), order.end(), added.begin(), added.end(), std::back_inserter(merged), before);
+                return make_index(SortedIndex<T>::adopt(std::move(merged), false));
+            });
+        }
+
+        /**
+         * @brief Finds where a sorted-order iterator continues after the container changed.
+         * @details The iterator keeps pointing at the same element: its index is carried through the
+         * logged removals and then located in the current permutation by binary search. If the element
+         * was removed, the iterator moves to the next element of the old order that is still there.
+         * An end iterator stays at the end, and so does an iterator that cannot be followed: one the
+         * log no longer reaches back to, or one whose lazy permutation would have to be sorted further
+         * with elements that were removed since.
+         * @param old The permutation the iterator walked until now.
+         * @param pos The iterator's position in old.
+         * @param since The container version old belongs to.
+         * @param current The up-to-date permutation, in the same direction as old.
+         * @param descending True for a descending permutation.
+         * @return The iterator's position in current.
+         */
+        size_t track_position(const SortedIndex<T>& old, size_t pos, size_t since,
+                              const SortedIndex<T>& current, bool descending) const {
+            current.complete(data);
+            if (pos >= old.size()) {
+                return current.size();
+            }
+            if (since < log_start) {
+                return current.size();
+            }
+
+            // Adds only append, so until a removal renumbers data the old indices still refer to the
+            // same elements and a lazy old permutation can keep sorting with the current data
+            const std::vector<Removal>& removals = removal_log();
+            bool renumbered = !removals.empty() && removals.back().version > since;
+            auto carry = [&removals, since](size_t index) {
+                for (const Removal& removal : removals) {
+                    if (removal.version > since && index != NPOS) {
+                        index = renumber(index, removal.indices);
+                    }
+                }
+                return index;
+            };
+            size_t index = NPOS; // Current index of the first element from pos on that is still there
+            for (size_t p = pos; p < old.size() && index == NPOS; ++p) {
+                if (renumbered && !old.known(p)) {
+                    return current.size();
+                }
+                index = carry(old.at(p, data));
+            }
+            if (index == NPOS) {
+                return current.size();
+            }
+
+            auto earlier = [this, index, descending](size_t i) {
+                return IndexSort::before(i, index, data.get(), descending);
+            };
+            return current.visit([this, &earlier](const auto& perm) {
+                const auto& order = perm.complete(data);
+                return static_cast<size_t>(std::partition_point(order.begin(), order.end(), earlier) - order.begin());
+            });
+        }
+
+        /**
+         * @brief Brings the cached ascending permutation up to date; the caller holds cache_mutex.
+         * @details After add()/remove() the previous permutation is patched rather than sorted again,
+         * as long as the removal log still covers it.
+         * @return Shared handle to the cached ascending permutation.
+         */
+        std::shared_ptr<const SortedIndex<T>> current_ascending() const {
+            if (asc_version != version) {
+                if (asc_cache && asc_version >= log_start && asc_cache->is_complete()
+                    && (asc_cache->wide() || SortedIndex<T>::fits_narrow(data.size()))) {
+                    patch_ascending();
+                } else {
+                    asc_cache = make_index(data.get(), false, lazy_sort);
+                }
+                asc_version = version;
+            }
+            return asc_cache;
+        }
+
+        /**
+         * @brief Returns the indices of data in ascending order, sorting only if the container changed.
+         * @return Shared handle to the cached ascending permutation.
+         */
+        std::shared_ptr<const SortedIndex<T>> ascending_indices() const {
+            settle();
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            return current_ascending();
+        }
+
+        /**
+         * @brief Returns the indices of data in descending order, rebuilding them only if the container changed.
+         * @details The descending permutation is derived from the ascending one in O(n), so a container
+         * read in both directions is sorted once. A lazy container keeps its own heap instead, since
+         * reading the largest few elements should not sort the whole ascending permutation.
+         * @return Shared handle to the cached descending permutation.
+         */
+        std::shared_ptr<const SortedIndex<T>> descending_indices() const {
+            settle();
+            std::lock_guard<std::mutex> lock(cache_mutex);
+            if (desc_version != version) {
+                if (lazy_sort) {
+                    desc_cache = make_index(data.get(), true, true);
+                } else {
+                    desc_cache = make_index(SortedIndex<T>::reverse_of(*current_ascending(), data));
+                }
+                desc_version = version;
+            }
+            return desc_cache;
+        }
+
+    protected:
+        /**
+         * @brief Marks the memory resource as part of this object, as in SmallContainer.
+         * @details Moving the container then copies its elements to the default memory resource
+         * instead of handing over buffers that die with the object.
+         */
+        void pin_resource() noexcept {
+            pinned = true;
+        }
+
     public:
         /**
-         * @brief Default constructor.
+         * @brief Default constructor. Allocates from the default memory resource.
          */
-        MyContainer() = default;
+        MyContainer() : MyContainer(std::pmr::get_default_resource()) {}
+
+        /**
+         * @brief Creates a container that allocates from the given memory resource.
+         * @details The elements, the sorted permutations and their sorting buffers, the shared handles
+         * the iterators hold, the value index and the tombstones all come from the resource, so a
+         * container backed by e.g. a std::pmr::monotonic_buffer_resource is freed by releasing it.
+         * The resource must outlive the container and every iterator over it.
+         * @param resource The memory resource to allocate from.
+         */
+        explicit MyContainer(std::pmr::memory_resource* resource)
+            : data(resource) {}
 
         /**
          * @brief Default destructor.
@@ -44,24 +750,219 @@ namespace Container{
         ~MyContainer()= default;
         
         /**
-         * @brief Copy constructor. Defaulted since vector handles it.
+         * @brief Copy constructor. Like other std::pmr containers, the copy uses the default memory resource.
          * @param other The container to copy from.
          */
-        MyContainer(const MyContainer&) = default;
+        MyContainer(const MyContainer& other)
+            : MyContainer(other, std::pmr::get_default_resource()) {}
 
         /**
-         * @brief Copy assignment operator. Defaulted since vector handles it.
+         * @brief Copy constructor that allocates the copy from the given memory resource.
+         * @details On a memory resource equal to other's, the elements are shared rather than copied
+         * until either container changes them.
+         * @param other The container to copy from.
+         * @param resource The memory resource for the copy.
+         */
+        MyContainer(const MyContainer& other, std::pmr::memory_resource* resource)
+            : data(other.data, resource) {
+            copy_state(other);
+        }
+
+        /**
+         * @brief Copy assignment operator. This container keeps its memory resource.
          * @param other The container to assign from.
          * @return Reference to this container.
          */
-        MyContainer& operator=(const MyContainer&) = default;
+        MyContainer& operator=(const MyContainer& other) {
+            if (this != &other) {
+                size_t newer = std::max(version, other.version) + 1;
+                data = other.data;
+                copy_state(other);
+                restamp(newer);
+            }
+            return *this;
+        }
+
+        /**
+         * @brief Move constructor. Takes over the elements, the cached sorted permutations and the
+         * value index without copying, and keeps the other container's memory resource.
+         * @details A SmallContainer's resource is inside the object being moved from, so its elements
+         * are moved one by one to the default resource instead; an allocation failure there terminates, as in
+         * any noexcept function.
+         * @param other The container to move from; left empty but usable.
+         */
+        MyContainer(MyContainer&& other) noexcept
+            : MyContainer(other.pinned ? std::pmr::get_default_resource() : other.resource()) {
+            if (other.pinned) {
+                move_across(other);
+            } else {
+                swap(other);
+            }
+            other.clear_moved_from();
+        }
+
+        /**
+         * @brief Move assignment operator.
+         * @details With an equal memory resource on both sides (always the case for containers on the
+         * default resource) this swaps buffers and caches in O(1) and cannot throw. Otherwise the
+         * elements are moved into this container's resource one by one, as with std::pmr::vector, which
+         * is why the operator is not noexcept; the sorted permutations are rebuilt on the next sorted read.
+         * @param other The container to move from; left empty but usable.
+         * @return Reference to this container.
+         */
+        MyContainer& operator=(MyContainer&& other) {
+            if (this == &other) {
+                return *this;
+            }
+            if (!resource()->is_equal(*other.resource())) {
+                move_across(other);
+                other.clear_moved_from();
+                return *this;
+            }
+            MyContainer moved(std::move(other));
+            swap(moved);
+            return *this;
+        }
+
+        /**
+         * @brief Exchanges the contents of two containers, cached permutations included.
+         * @details O(1) and non-throwing when both containers use equal memory resources; otherwise each
+         * side's elements are moved into the other's resource.
+         * @param other The container to swap with.
+         */
+        void swap(MyContainer& other) {
+            if (this == &other) {
+                return;
+            }
+            if (!resource()->is_equal(*other.resource())) {
+                MyContainer mine(std::move(*this));
+                *this = std::move(other);
+                other = std::move(mine);
+                return;
+            }
+            using std::swap;
+            data.swap(other.data);
+            swap(version, other.version);
+            swap(asc_cache, other.asc_cache);
+            swap(asc_version, other.asc_version);
+            swap(desc_cache, other.desc_cache);
+            swap(desc_version, other.desc_version);
+            swap(incremental_sort, other.incremental_sort);
+            swap(lazy_sort, other.lazy_sort);
+            swap(log_start, other.log_start);
+            swap(extras, other.extras);
+            swap(deferred_remove, other.deferred_remove);
+            size_t newer = std::max(version, other.version) + 1;
+            restamp(newer);
+            other.restamp(newer);
+        }
+
+        /**
+         * @brief Exchanges the contents of two containers.
+         * @param a The first container.
+         * @param b The second container.
+         */
+        friend void swap(MyContainer& a, MyContainer& b) {
+            a.swap(b);
+        }
+
+        /**
+         * @brief Takes a read-only snapshot of the container in O(1).
+         * @details The snapshot shares the elements and the cached sorted permutations with this
+         * container, and every iterator works on it. When this container changes next it copies the
+         * elements (once, in O(n)), so later add()/remove() calls never show through. Pending
+         * tombstones are compacted first. The value index is not carried over, since it is O(n) to copy.
+         * A SmallContainer's arena dies with it, so its snapshots copy the elements to the default
+         * memory resource instead of sharing them.
+         * @return The read-only snapshot.
+         */
+        Snapshot<T> snapshot() const {
+            settle();
+            Snapshot<T> snap(pinned ? std::pmr::get_default_resource() : resource());
+            MyContainer& view = snap;
+            view.data = data;
+            view.version = version;
+            if (view.resource()->is_equal(*resource())) {
+                view.asc_cache = asc_cache;
+                view.asc_version = asc_version;
+                view.desc_cache = desc_cache;
+                view.desc_version = desc_version;
+            }
+            view.lazy_sort = lazy_sort;
+            view.log_start = version; // No iterator over the snapshot predates it
+            return snap;
+        }
+
+        /**
+         * @brief Returns the memory resource the container allocates from.
+         * @return The memory resource.
+         */
+        std::pmr::memory_resource* resource() const {
+            return data.resource();
+        }
 
         /**
          * @brief Adds a new element to the container.
          * @param value The value to add.
          */
         void add(const T& value) {
-            data.push_back(value);
+            data.write().push_back(value);
+            appended();
+        }
+
+        /**
+         * @brief Adds a new element to the container, moving it in.
+         * @param value The value to add.
+         */
+        void add(T&& value) {
+            data.write().push_back(std::move(value));
+            appended();
+        }
+
+        /**
+         * @brief Constructs a new element in place at the end of the container.
+         * @param args Arguments forwarded to the constructor of T.
+         */
+        template<typename... Args>
+        void emplace(Args&&... args) {
+            data.write().emplace_back(std::forward<Args>(args)...);
+            appended();
+        }
+
+        /**
+         * @brief Adds all elements of a range, in order.
+         * @details Forward ranges are inserted with a single reallocation; pass move iterators
+         * (std::make_move_iterator) to move the elements in instead of copying them.
+         * The sorted permutations are not touched per element: the next sorted read merges the
+         * whole batch in, which beats k binary-search inserts even with incremental sorting on.
+         * @param first Start of the range.
+         * @param last End of the range.
+         */
+        template<typename InputIt>
+        void add_range(InputIt first, InputIt last) {
+            auto old_size = data.size();
+            auto& elements = data.write();
+            elements.insert(elements.end(), first, last);
+            if (data.size() != old_size) {
+                index_positions(old_size);
+                ++version;
+            }
+        }
+
+        /**
+         * @brief Adds all given values, in order.
+         * @param values The values to add.
+         */
+        void add(std::initializer_list<T> values) {
+            add_range(values.begin(), values.end());
+        }
+
+        /**
+         * @brief Reserves storage so that adding up to n elements in total does not reallocate.
+         * @param n The number of elements to make room for.
+         */
+        void reserve(size_t n) {
+            data.write().reserve(n);
         }
 
         /**
@@ -70,22 +971,200 @@ namespace Container{
          * @throw std::runtime_error If the value is not found in the container.
          */
         void remove(const T& value) {
-            auto old_size = data.size(); // Store the old size for error checking
-            auto it = std::remove(data.begin(), data.end(), value);
-            data.erase(it, data.end()); // Erase the elements that were removed
-
-            // If the size hasn't changed, the element was not found
-            if (data.size() == old_size) {
+            if (try_remove(value) == 0) {
                 throw std::runtime_error("Element not found in container");
             }
         }
 
+        /**
+         * @brief Removes all occurrences of the given value, if there are any.
+         * @param value The value to remove.
+         * @return The number of elements removed.
+         */
+        size_t try_remove(const T& value) {
+            if constexpr (is_hashable<T>::value) {
+                if (PositionIndex* positions = value_index()) {
+                    auto it = positions->find(value);
+                    if (it == positions->end()) {
+                        return 0;
+                    }
+                    std::vector<size_t> removed(it->second.begin(), it->second.end());
+                    return erase_indices(std::move(removed));
+                }
+            }
+            return remove_if([&value](const T& element) {
+                return element == value;
+            });
+        }
+
+        /**
+         * @brief Removes every element equal to one of the given values, in a single pass over the container.
+         * @details The values are put in a hash set when T is hashable, otherwise sorted and probed by
+         * binary search, so k values cost O(n) or O(n log k) instead of k passes. Either way elements match
+         * by operator==, as in remove().
+         * Values that are not in the container are skipped.
+         * @param values A range of values to remove.
+         * @return The number of elements removed.
+         */
+        template<typename Range>
+        size_t remove_all(const Range& values) {
+            if constexpr (is_hashable<T>::value) {
+                std::unordered_set<T> lookup(std::begin(values), std::end(values));
+                if (lookup.empty()) {
+                    return 0;
+                }
+                return remove_if([&lookup](const T& element) {
+                    return lookup.count(element) != 0;
+                });
+            } else {
+                std::vector<T> lookup(std::begin(values), std::end(values));
+                if (lookup.empty()) {
+                    return 0;
+                }
+                std::sort(lookup.begin(), lookup.end());
+                return remove_if([&lookup](const T& element) {
+                    // operator< only narrows the search; equality is still decided by operator==
+                    auto range = std::equal_range(lookup.begin(), lookup.end(), element);
+                    return std::find(range.first, range.second, element) != range.second;
+                });
+            }
+        }
+
+        /**
+         * @brief Removes every element equal to one of the given values, in a single pass over the container.
+         * @param values The values to remove.
+         * @return The number of elements removed.
+         */
+        size_t remove_all(std::initializer_list<T> values) {
+            return remove_all<std::initializer_list<T>>(values);
+        }
+
+        /**
+         * @brief Removes every element the predicate accepts, in a single pass over the container.
+         * @details The predicate is called once per element, in insertion order.
+         * @param pred Callable taking const T& and returning true for elements to remove.
+         * @return The number of elements removed.
+         */
+        template<typename Pred>
+        size_t remove_if(Pred pred) {
+            std::vector<size_t> removed;
+            for (size_t i = 0; i < data.size(); ++i) {
+                if (!is_dead(i) && pred(static_cast<const T&>(data[i]))) {
+                    removed.push_back(i);
+                }
+            }
+            return erase_indices(std::move(removed));
+        }
+
+        /**
+         * @brief Checks whether the container holds an element equal to the value.
+         * @details O(1) on average with the value index, a linear scan otherwise.
+         * @param value The value to look for.
+         * @return True if the value is present.
+         */
+        bool contains(const T& value) const {
+            return count(value) != 0;
+        }
+
+        /**
+         * @brief Counts the elements equal to the value.
+         * @details O(1) on average with the value index, a linear scan otherwise.
+         * @param value The value to count.
+         * @return The number of equal elements.
+         */
+        size_t count(const T& value) const {
+            if constexpr (is_hashable<T>::value) {
+                if (const PositionIndex* positions = value_index()) {
+                    auto it = positions->find(value);
+                    return it == positions->end() ? 0 : it->second.size();
+                }
+            }
+            size_t found = 0;
+            for (size_t i = 0; i < data.size(); ++i) {
+                if (!is_dead(i) && data[i] == value) {
+                    ++found;
+                }
+            }
+            return found;
+        }
+
+        /**
+         * @brief Turns incremental maintenance of the sorted permutations on or off.
+         * @details When enabled, add() inserts the new element into the cached permutations by binary
+         * search and remove() renumbers them, so begin_asc()/begin_desc() stay O(1) after a mutation
+         * instead of re-sorting. Pays off for workloads that interleave single adds with sorted reads.
+         * @param enable True to maintain the permutations on every mutation.
+         */
+        void set_incremental_sort(bool enable) {
+            incremental_sort = enable;
+        }
+
+        /**
+         * @brief Turns lazy sorting of new permutations on or off.
+         * @details When enabled, a sorted traversal heapifies the indices in O(n) and sorts only as far
+         * as it reads, so taking the k smallest (or largest) elements costs O(n + k log n).
+         * Side-cross traversal reads the largest element second and incremental maintenance edits the
+         * whole permutation, so both still end up sorting all of it.
+         * @param enable True to build permutations lazily.
+         */
+        void set_lazy_sort(bool enable) {
+            lazy_sort = enable;
+        }
+
+        /**
+         * @brief Turns the value index on or off.
+         * @details The index maps each distinct value to its positions, so remove(), try_remove(),
+         * contains() and count() find a value without comparing it against every element, and a missing
+         * value is detected in O(1) on average. It costs a hash insert per add, and removals renumber
+         * the stored positions. Building it takes one pass over the elements. Requires std::hash<T>.
+         * @param enable True to keep the value index.
+         */
+        void set_value_index(bool enable) {
+            static_assert(is_hashable<T>::value, "The value index needs std::hash<T>");
+            if (!enable) {
+                if (extras) {
+                    extras->positions.reset();
+                }
+            } else if (!value_index()) {
+                settle();
+                PositionIndex& positions = extra().positions.emplace(resource());
+                positions.reserve(data.size());
+                index_positions(0);
+            }
+        }
+
+        /**
+         * @brief Turns deferred removal on or off.
+         * @details When enabled, removing only marks the slots as tombstones, so a stream of removes
+         * by value costs amortized O(1) each with the value index on. The slots are compacted in one
+         * O(n) pass when more than 1/COMPACT_FRACTION of them are dead, when compact() is called, or
+         * when the container is next traversed. Traversals always start on compacted storage, so the
+         * iterators keep O(1) random access instead of skipping tombstones one by one; only iterators
+         * taken before a deferred remove step over its tombstones until the next compaction.
+         * Turning it off compacts right away.
+         * @param enable True to defer removals.
+         */
+        void set_deferred_remove(bool enable) {
+            deferred_remove = enable;
+            if (!enable) {
+                settle();
+            }
+        }
+
+        /**
+         * @brief Compacts the slots of elements removed in deferred mode.
+         * @details The cached sorted permutations are renumbered rather than sorted again.
+         */
+        void compact() {
+            settle();
+        }
+
         /**
          * @brief Returns the number of elements in the container.
          * @return The size of the container.
          */
         size_t size() const {
-            return data.size();
+            return data.size() - (extras ? extras->dead_count : 0);
         }
 
         /**
@@ -96,116 +1175,232 @@ namespace Container{
          */        
         friend std::ostream& operator<<(std::ostream& os, const MyContainer& container) {
             os << "[";
+            bool first = true;
             for (size_t i = 0; i < container.data.size(); ++i) {
+                if (container.is_dead(i)) {
+                    continue;
+                }
+                if (!first) os << ", ";
                 os << container.data[i];
-                if (i != container.data.size() - 1) os << ", ";
+                first = false;
             }
             os << "]";
             return os;
         }
 
-        friend class AscendingOrderIterator<T>;
-        friend class DescendingOrderIterator<T>;
-        friend class SideCrossOrderIterator<T>;
-        friend class ReverseOrderIterator<T>;
-        friend class OrderIterator<T>;
-        friend class MiddleOutOrderIterator<T>;
+        template<typename, typename> friend class AscendingOrderIterator;
+        template<typename, typename> friend class DescendingOrderIterator;
+        template<typename, typename> friend class SideCrossOrderIterator;
+        template<typename, typename> friend class ReverseOrderIterator;
+        template<typename, typename> friend class OrderIterator;
+        template<typename, typename> friend class MiddleOutOrderIterator;
 
-        // Iterator accessors
+        // Iterator accessors. Each one takes an optional bounds policy, e.g. begin_asc<Unchecked>(),
+        // which defaults to checked iterators in debug builds and unchecked ones under NDEBUG.
         /**
          * @brief Returns an iterator to the beginning of the container in ascending order.
          * @return An iterator to the beginning of the container.
          */
+        template<typename Bounds = DefaultBounds>
         auto begin_asc() const { 
-            return AscendingOrderIterator<T>(*this, 0); 
+            settle();
+            return AscendingOrderIterator<T, Bounds>(*this, 0); 
         }
 
         /**
          * @brief Returns an iterator to the end of the container in ascending order.
          * @return An iterator to the end of the container.
          */
+        template<typename Bounds = DefaultBounds>
         auto end_asc() const { 
-            return AscendingOrderIterator<T>(*this, data.size()); 
+            settle();
+            return AscendingOrderIterator<T, Bounds>(*this, data.size()); 
         }
 
         /**
          * @brief Returns an iterator to the beginning of the container in descending order.
          * @return An iterator to the beginning of the container.
          */
+        template<typename Bounds = DefaultBounds>
         auto begin_desc() const { 
-            return DescendingOrderIterator<T>(*this, 0); 
+            settle();
+            return DescendingOrderIterator<T, Bounds>(*this, 0); 
         }
 
         /**
          * @brief Returns an iterator to the end of the container in descending order.
          * @return An iterator to the end of the container.
          */
+        template<typename Bounds = DefaultBounds>
         auto end_desc() const { 
-            return DescendingOrderIterator<T>(*this, data.size()); 
+            settle();
+            return DescendingOrderIterator<T, Bounds>(*this, data.size()); 
         }
 
         /**
          * @brief Returns an iterator to traverse the container in side-cross order.
          * @return An iterator for side-cross order traversal.
          */
+        template<typename Bounds = DefaultBounds>
         auto begin_sidecross() const { 
-            return SideCrossOrderIterator<T>(*this, 0); 
+            settle();
+            return SideCrossOrderIterator<T, Bounds>(*this, 0); 
         }
 
         /**
          * @brief Returns an iterator to the end of the container in side-cross order.
          * @return An iterator to the end of the container.
          */
+        template<typename Bounds = DefaultBounds>
         auto end_sidecross() const { 
-            return SideCrossOrderIterator<T>(*this, data.size()); 
+            settle();
+            return SideCrossOrderIterator<T, Bounds>(*this, data.size()); 
         }
 
         /**
          * @brief Returns an iterator to the beginning of the container in reverse order.
          * @return An iterator to the beginning of the container in reverse order.
          */
+        template<typename Bounds = DefaultBounds>
         auto begin_reverse() const { 
-            return ReverseOrderIterator<T>(*this, 0); 
+            settle();
+            return ReverseOrderIterator<T, Bounds>(*this, 0); 
         }
 
         /**
          * @brief Returns an iterator to the end of the container in reverse order.
          * @return An iterator to the end of the container in reverse order.
          */
+        template<typename Bounds = DefaultBounds>
         auto end_reverse() const { 
-            return ReverseOrderIterator<T>(*this, data.size()); 
+            settle();
+            return ReverseOrderIterator<T, Bounds>(*this, data.size()); 
         }
 
         /**
          * @brief Returns an iterator to the beginning of the container in insertion order.
          * @return An iterator to the beginning of the container in insertion order.
          */
+        template<typename Bounds = DefaultBounds>
         auto begin_order() const { 
-            return OrderIterator<T>(*this, 0); 
+            settle();
+            return OrderIterator<T, Bounds>(*this, 0); 
         }
 
         /**
          * @brief Returns an iterator to the end of the container in insertion order.
          * @return An iterator to the end of the container in insertion order.
          */
+        template<typename Bounds = DefaultBounds>
         auto end_order() const { 
-            return OrderIterator<T>(*this, data.size()); 
+            settle();
+            return OrderIterator<T, Bounds>(*this, data.size()); 
+        }
+
+        /**
+         * @brief Returns a pointer to the first element, in insertion order.
+         * @details Escape hatch for algorithms that need contiguous memory (std::accumulate,
+         * std::copy, memcpy, SIMD code). Invalidated by add() and remove().
+         * @return Pointer to the contiguous element storage.
+         */
+        const T* begin_raw() const {
+            settle();
+            return data.data();
+        }
+
+        /**
+         * @brief Returns a pointer one past the last element, in insertion order.
+         * @return Pointer to the end of the contiguous element storage.
+         */
+        const T* end_raw() const {
+            settle();
+            return data.data() + data.size();
         }
 
         /**
          * @brief Returns an iterator to the beginning of the container in middle-out order.
          * @return An iterator to the beginning of the container in middle-out order.
          */
+        template<typename Bounds = DefaultBounds>
         auto begin_middleout() const { 
-            return MiddleOutOrderIterator<T>(*this, 0); 
+            settle();
+            return MiddleOutOrderIterator<T, Bounds>(*this, 0); 
         }
 
         /**
          * @brief Returns an iterator to the end of the container in middle-out order.
          * @return An iterator to the end of the container in middle-out order.
          */
+        template<typename Bounds = DefaultBounds>
         auto end_middleout() const { 
-            return MiddleOutOrderIterator<T>(*this, data.size()); 
+            settle();
+            return MiddleOutOrderIterator<T, Bounds>(*this, data.size()); 
+        }
+    };
+
+    /**
+     * @brief Read-only view of a MyContainer, taken with MyContainer::snapshot().
+     *
+     * @details
+     * Holds the contents the container had when the snapshot was taken, sharing the elements and
+     * the cached sorted permutations with it until the container changes. Only the const interface
+     * is offered: size and lookups, printing and all six iterators. Copying a snapshot is O(1), since
+     * the copy stays on the same memory resource; assigning one to a snapshot on another resource copies.
+     *
+     * @tparam T The type of elements stored in the container.
+     */
+    template<typename T>
+    class Snapshot : private MyContainer<T> {
+
+    private:
+        friend class MyContainer<T>;
+
+        /**
+         * @brief Creates an empty snapshot; MyContainer::snapshot() fills it in.
+         * @param resource The memory resource to allocate from.
+         */
+        explicit Snapshot(std::pmr::memory_resource* resource) : MyContainer<T>(resource) {}
+
+    public:
+        /**
+         * @brief Copy constructor. Unlike a MyContainer copy, keeps other's memory resource, so the
+         * copy shares the elements and permutations instead of copying them.
+         * @param other The snapshot to copy.
+         */
+        Snapshot(const Snapshot& other) : MyContainer<T>(other, other.resource()) {}
+
+        Snapshot(Snapshot&&) noexcept = default;
+        Snapshot& operator=(const Snapshot&) = default;
+        Snapshot& operator=(Snapshot&&) = default;
+
+        using MyContainer<T>::size;
+        using MyContainer<T>::contains;
+        using MyContainer<T>::count;
+        using MyContainer<T>::resource;
+        using MyContainer<T>::snapshot;
+        using MyContainer<T>::begin_asc;
+        using MyContainer<T>::end_asc;
+        using MyContainer<T>::begin_desc;
+        using MyContainer<T>::end_desc;
+        using MyContainer<T>::begin_sidecross;
+        using MyContainer<T>::end_sidecross;
+        using MyContainer<T>::begin_reverse;
+        using MyContainer<T>::end_reverse;
+        using MyContainer<T>::begin_order;
+        using MyContainer<T>::end_order;
+        using MyContainer<T>::begin_middleout;
+        using MyContainer<T>::end_middleout;
+        using MyContainer<T>::begin_raw;
+        using MyContainer<T>::end_raw;
+
+        /**
+         * @brief Output stream operator.
+         * @param os The output stream.
+         * @param snap The snapshot to output.
+         * @return Reference to the output stream.
+         */
+        friend std::ostream& operator<<(std::ostream& os, const Snapshot& snap) {
+            return os << static_cast<const MyContainer<T>&>(snap);
         }
     };
     
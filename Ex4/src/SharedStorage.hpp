@@ -0,0 +1,200 @@
+// Email: shanig7531@gmail.com
+
+#ifndef SHARED_STORAGE_HPP
+#define SHARED_STORAGE_HPP
+
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <memory_resource>
+#include <utility>
+#include <vector>
+
+namespace Container {
+
+    /**
+     * @brief Element buffer that copies share until one of them is written to (copy-on-write).
+     *
+     * @details
+     * Reads go straight to the shared std::pmr::vector. write() first gives the buffer a private
+     * copy if another handle still shares it, so a copy costs O(1) and the first write after it
+     * pays for the one O(n) copy. The vector object itself is allocated on first use, so an empty
+     * or moved-from handle does not allocate.
+     * Sharing is only done between handles on equal memory resources; otherwise copies are deep.
+     * Like std::shared_ptr, a handle may be copied while other threads read other handles, but a
+     * handle must not be written to while it is being copied.
+     *
+     * @tparam T The type of elements stored.
+     */
+    template<typename T>
+    class SharedStorage {
+
+    private:
+        std::pmr::memory_resource* memory; // Resource the buffer and its copies allocate from
+        mutable std::shared_ptr<std::pmr::vector<T>> buffer; // Null until first used
+
+        /**
+         * @brief Allocates a new buffer, control block included, from the memory resource.
+         * @param args Arguments forwarded to the vector constructor; the allocator is passed on to the vector.
+         * @return The new buffer.
+         */
+        template<typename... Args>
+        std::shared_ptr<std::pmr::vector<T>> make_buffer(Args&&... args) const {
+            return std::allocate_shared<std::pmr::vector<T>>(
+                std::pmr::polymorphic_allocator<std::pmr::vector<T>>(memory), std::forward<Args>(args)...);
+        }
+
+    public:
+        /**
+         * @brief Creates an empty buffer.
+         * @param resource The memory resource to allocate from.
+         */
+        explicit SharedStorage(std::pmr::memory_resource* resource) : memory(resource) {}
+
+        /**
+         * @brief Creates a handle that shares other's buffer, or copies it if the resources differ.
+         * @param other The buffer to copy.
+         * @param resource The memory resource for the copy.
+         */
+        SharedStorage(const SharedStorage& other, std::pmr::memory_resource* resource) : memory(resource) {
+            *this = other;
+        }
+
+        /**
+         * @brief Copy constructor. Shares other's buffer.
+         * @param other The buffer to copy.
+         */
+        SharedStorage(const SharedStorage& other) = default;
+
+        /**
+         * @brief Move constructor. Takes over other's buffer and leaves other empty.
+         * @param other The buffer to move from.
+         */
+        SharedStorage(SharedStorage&& other) noexcept = default;
+
+        /**
+         * @brief Copy assignment operator. This handle keeps its memory resource.
+         * @param other The buffer to assign from.
+         * @return Reference to this handle.
+         */
+        SharedStorage& operator=(const SharedStorage& other) {
+            if (!other.buffer || memory->is_equal(*other.memory)) {
+                buffer = other.buffer;
+            } else {
+                buffer = make_buffer(*other.buffer);
+            }
+            return *this;
+        }
+
+        SharedStorage& operator=(SharedStorage&&) = delete;
+
+        /**
+         * @brief Returns the memory resource the buffer allocates from.
+         * @return The memory resource.
+         */
+        std::pmr::memory_resource* resource() const {
+            return memory;
+        }
+
+        /**
+         * @brief Returns the number of elements.
+         * @return The size of the buffer.
+         */
+        size_t size() const {
+            return buffer ? buffer->size() : 0;
+        }
+
+        /**
+         * @brief Returns an element.
+         * @param i Index of the element; must be less than size().
+         * @return Reference to the element.
+         */
+        const T& operator[](size_t i) const {
+            return (*buffer)[i];
+        }
+
+        /**
+         * @brief Returns a pointer to the first element.
+         * @return The start of the contiguous elements, or nullptr if there are none.
+         */
+        const T* data() const {
+            return buffer ? buffer->data() : nullptr;
+        }
+
+        /**
+         * @brief Returns the elements for reading.
+         * @return The shared vector, allocated from the memory resource on first use.
+         */
+        const std::pmr::vector<T>& get() const {
+            if (!buffer) {
+                buffer = make_buffer();
+            }
+            return *buffer;
+        }
+
+        /**
+         * @brief Returns the elements for reading.
+         * @return The shared vector.
+         */
+        operator const std::pmr::vector<T>&() const {
+            return get();
+        }
+
+        /**
+         * @brief Returns the elements for writing, copying them first if another handle shares them.
+         * @return A vector owned only by this handle.
+         */
+        std::pmr::vector<T>& write() {
+            if (!buffer) {
+                buffer = make_buffer();
+            } else if (buffer.use_count() > 1) {
+                buffer = make_buffer(*buffer);
+            }
+            return *buffer;
+        }
+
+        /**
+         * @brief Replaces the elements with other's, moved into this handle's memory resource.
+         * @details For unequal resources, where the buffer itself cannot change hands. Elements still
+         * shared with another handle are copied instead, so that handle keeps them. Leaves other empty.
+         * @param other The handle to take the elements from.
+         */
+        void take(SharedStorage& other) {
+            if (!other.buffer) {
+                buffer.reset();
+            } else if (other.shared()) {
+                buffer = make_buffer(*other.buffer);
+            } else {
+                buffer = make_buffer(std::make_move_iterator(other.buffer->begin()),
+                                     std::make_move_iterator(other.buffer->end()));
+            }
+            other.clear();
+        }
+
+        /**
+         * @brief Checks whether another handle shares the buffer.
+         * @return True if a write would copy the elements first.
+         */
+        bool shared() const {
+            return buffer.use_count() > 1;
+        }
+
+        /**
+         * @brief Drops this handle's reference to the elements, leaving it empty.
+         */
+        void clear() noexcept {
+            buffer.reset();
+        }
+
+        /**
+         * @brief Exchanges the buffers of two handles on equal memory resources.
+         * @param other The handle to swap with.
+         */
+        void swap(SharedStorage& other) noexcept {
+            buffer.swap(other.buffer);
+        }
+    };
+
+} // namespace Container
+
+#endif
@@ -3,63 +3,146 @@
 #ifndef SIDECROSS_ORDER_ITERATOR_HPP
 #define SIDECROSS_ORDER_ITERATOR_HPP
 
-#include <vector>
-#include <algorithm>
+#include <memory>
 #include <cstddef>
+#include <iterator>
+#include <stdexcept>
+#include "IteratorChecks.hpp"
+#include "SortedIndex.hpp"
 
 namespace Container {
 
     template<typename T>
-    class MyContainer; 
+    class MyContainer;
 
     /**
      * @brief Iterator for traversing the container in side-cross order:
      * smallest, largest, 2nd smallest, 2nd largest, etc.
      * @tparam T The type of elements stored in the container.
+     * @tparam Bounds Checked to throw std::out_of_range on misuse, Unchecked to drop the checks.
      */
-    template<typename T>
+    template<typename T, typename Bounds = DefaultBounds>
     class SideCrossOrderIterator {
 
     private:
-        const MyContainer<T>& container; // Reference to the container being iterated
-        std::vector<size_t> indices; // Indices in side-cross order
-        size_t pos; // Current position in the indices vector
+        const MyContainer<T>* container; // Container being iterated (a pointer, so iterators are assignable)
+        mutable std::shared_ptr<const SortedIndex<T>> indices; // Shared ascending permutation of the container
+        mutable size_t pos; // Current position in side-cross order
+        mutable size_t version; // Container version that indices and pos refer to
 
         /**
-         * @brief Builds the indices vector in side-cross order.
+         * @brief Returns the container's cached ascending permutation, fetching it on first use.
+         * @details Side-cross order needs no buffer of its own: position p is the (p/2)-th smallest
+         * element when p is even and the (p/2)-th largest when p is odd.
+         * @return The shared permutation this iterator walks.
          */
-        void build_indices() {
-            size_t n = container.size();
-            indices.resize(n);
-            std::vector<size_t> sorted_indices(n);
-            for (size_t i = 0; i < n; ++i) {
-                sorted_indices[i] = i;
+        const SortedIndex<T>& sorted() const {
+            if (!indices) {
+                indices = container->ascending_indices();
             }
-            // Sort indices by value (ascending)
-            std::sort(sorted_indices.begin(), sorted_indices.end(),
-                [this](size_t a, size_t b) {
-                    return container.data[a] < container.data[b];
-                });
-
-            // Fill indices in side-cross order: min, max, 2nd min, 2nd max, ...
-            size_t left = 0, right = n ? n - 1 : 0, idx = 0;
-            while (left <= right && idx < n) {
-                indices[idx++] = sorted_indices[left++];
-                if (left <= right && idx < n) {
-                    indices[idx++] = sorted_indices[right--];
+            return *indices;
+        }
+
+        /**
+         * @brief Checks whether the container changed since this iterator last caught up with it.
+         * @return True if pos and indices refer to an older version of the container.
+         */
+        bool stale() const {
+            return container != nullptr && version != container->version;
+        }
+
+        /**
+         * @brief Catches up with the container if it changed. Stepping and comparing skip this,
+         * so a traversal pays for one version check per dereference.
+         */
+        void sync() const {
+            if (stale()) {
+                resync();
+            }
+        }
+
+        /**
+         * @brief Catches up with add()/remove() calls made since this iterator last looked at the container.
+         * @details The iterator stays on the element it pointed at, or moves to the next one in order if
+         * that element was removed. An iterator that never fetched the permutation was at the end and
+         * stays there. Kept out of line so the checks that call it stay small enough to inline.
+         */
+        CONTAINER_NOINLINE void resync() const {
+            if (indices) {
+                auto current = container->ascending_indices();
+                if (pos >= indices->size()) {
+                    pos = current->size();
+                } else {
+                    size_t rank = container->track_position(*indices, ascending_position(pos), version, *current, false);
+                    pos = side_position(rank, current->size());
                 }
+                indices = std::move(current);
+            } else {
+                pos = container->size();
+            }
+            version = container->version;
+        }
+
+        /**
+         * @brief Maps a side-cross position to its position in ascending order.
+         * @param p Position in side-cross order.
+         * @return Position in ascending order.
+         * @note Reads the size of indices, so the permutation must have been fetched.
+         */
+        size_t ascending_position(size_t p) const {
+            return p % 2 == 0 ? p / 2 : indices->size() - 1 - p / 2;
+        }
+
+        /**
+         * @brief Maps a position in ascending order to its side-cross position.
+         * @param rank Position in ascending order.
+         * @param n Number of elements.
+         * @return Position in side-cross order, or n if rank is past the end.
+         */
+        static size_t side_position(size_t rank, size_t n) {
+            if (rank >= n) {
+                return n;
+            }
+            return rank < (n + 1) / 2 ? 2 * rank : 2 * (n - 1 - rank) + 1;
+        }
+
+        /**
+         * @brief Brings two iterators to the same container version before their positions are compared.
+         * @details Iterators taken at the same version compare positions directly, which is the common
+         * case of a loop against an end iterator taken alongside it.
+         * @param other The iterator to compare with.
+         */
+        void align(const SideCrossOrderIterator& other) const {
+            if (version != other.version) {
+                sync();
+                other.sync();
             }
         }
 
     public:
+        using iterator_category = std::random_access_iterator_tag;
+        using value_type = T;
+        using difference_type = std::ptrdiff_t;
+        using pointer = const T*;
+        using reference = const T&;
+
+        /**
+         * @brief Default constructor. Creates a singular iterator that may only be assigned to or compared.
+         */
+        SideCrossOrderIterator() : container(nullptr), pos(0), version(0) {}
+
         /**
          * @brief Constructor for the SideCrossOrderIterator.
          * @param cont Reference to the container.
          * @param start_pos The starting position for the iterator (default is 0).
+         * @note An iterator constructed at or past the end only compares positions,
+         * so it skips fetching the permutation until it is first dereferenced.
          */
         SideCrossOrderIterator(const MyContainer<T>& cont, size_t start_pos = 0)
-            : container(cont), pos(start_pos) {
-            build_indices();
+            : container(&cont), pos(start_pos), version(cont.version) {
+            if (pos < container->size()) {
+                sorted();
+            }
         }
 
         /**
@@ -68,10 +151,31 @@ namespace Container {
          * @throw std::out_of_range If iterator is out of bounds
          */
         const T& operator*() const {
-            if (pos >= container.size()) {
+            sync();
+            if (Bounds::enabled && pos >= container->size()) {
                 throw std::out_of_range("Iterator out of bounds");
             }
-            return container.data[indices[pos]];
+            const SortedIndex<T>& index = sorted();
+            return container->data[index.at(ascending_position(pos), container->data)];
+        }
+
+        /**
+         * @brief Member access operator.
+         * @return Pointer to the current element in the container.
+         * @throw std::out_of_range If iterator is out of bounds
+         */
+        const T* operator->() const {
+            return &**this;
+        }
+
+        /**
+         * @brief Subscript operator.
+         * @param n Offset from the current position.
+         * @return Reference to the element n positions away.
+         * @throw std::out_of_range If the position is out of bounds
+         */
+        const T& operator[](difference_type n) const {
+            return *(*this + n);
         }
 
         /**
@@ -80,8 +184,11 @@ namespace Container {
          * @throw std::out_of_range If incrementing past the end
          */
         SideCrossOrderIterator& operator++() {
-            if (pos >= container.size()) {
-                throw std::out_of_range("Cannot increment iterator past end");
+            if (Bounds::enabled && pos >= container->size()) {
+                sync(); // The container may have grown since
+                if (pos >= container->size()) {
+                    throw std::out_of_range("Cannot increment iterator past end");
+                }
             }
             ++pos;
             return *this;
@@ -93,21 +200,116 @@ namespace Container {
          * @throw std::out_of_range If incrementing past the end
          */
         SideCrossOrderIterator operator++(int) {
-            if (pos >= container.size()) {
-                throw std::out_of_range("Cannot increment iterator past end");
+            SideCrossOrderIterator temp = *this;
+            ++*this;
+            return temp;
+        }
+
+        /**
+         * @brief Pre-decrement operator.
+         * @return Reference to the iterator after decrement.
+         * @throw std::out_of_range If decrementing before the beginning
+         */
+        SideCrossOrderIterator& operator--() {
+            if (Bounds::enabled && pos == 0) {
+                throw std::out_of_range("Cannot decrement iterator before begin");
             }
+            --pos;
+            return *this;
+        }
+
+        /**
+         * @brief Post-decrement operator.
+         * @return Copy of iterator before decrement.
+         * @throw std::out_of_range If decrementing before the beginning
+         */
+        SideCrossOrderIterator operator--(int) {
             SideCrossOrderIterator temp = *this;
-            ++pos;
+            --*this;
             return temp;
         }
 
+        /**
+         * @brief Moves the iterator by n positions.
+         * @param n Number of positions, negative to move backwards.
+         * @return Reference to the moved iterator.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        SideCrossOrderIterator& operator+=(difference_type n) {
+            difference_type target = static_cast<difference_type>(pos) + n;
+            if (Bounds::enabled && (target < 0 || static_cast<size_t>(target) > container->size())) {
+                sync(); // The container may have changed since
+                target = static_cast<difference_type>(pos) + n;
+                if (target < 0 || static_cast<size_t>(target) > container->size()) {
+                    throw std::out_of_range("Cannot move iterator out of bounds");
+                }
+            }
+            pos = static_cast<size_t>(target);
+            return *this;
+        }
+
+        /**
+         * @brief Moves the iterator back by n positions.
+         * @param n Number of positions, negative to move forwards.
+         * @return Reference to the moved iterator.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        SideCrossOrderIterator& operator-=(difference_type n) {
+            return *this += -n;
+        }
+
+        /**
+         * @brief Returns an iterator n positions ahead.
+         * @param n Number of positions, negative to move backwards.
+         * @return The moved copy.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        SideCrossOrderIterator operator+(difference_type n) const {
+            SideCrossOrderIterator temp = *this;
+            return temp += n;
+        }
+
+        /**
+         * @brief Returns an iterator n positions ahead.
+         * @param n Number of positions, negative to move backwards.
+         * @param it The iterator to move.
+         * @return The moved copy.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        friend SideCrossOrderIterator operator+(difference_type n, const SideCrossOrderIterator& it) {
+            return it + n;
+        }
+
+        /**
+         * @brief Returns an iterator n positions back.
+         * @param n Number of positions, negative to move forwards.
+         * @return The moved copy.
+         * @throw std::out_of_range If the new position is outside [begin, end]
+         */
+        SideCrossOrderIterator operator-(difference_type n) const {
+            SideCrossOrderIterator temp = *this;
+            return temp -= n;
+        }
+
+        /**
+         * @brief Distance between two iterators over the same container.
+         * @param other The iterator to measure from.
+         * @return Number of increments needed to get from other to this iterator.
+         */
+        difference_type operator-(const SideCrossOrderIterator& other) const {
+            sync();
+            other.sync();
+            return static_cast<difference_type>(pos) - static_cast<difference_type>(other.pos);
+        }
+
         /**
          * @brief Equality comparison operator.
          * @param other Another iterator to compare.
          * @return True if both iterators are at the same position and container.
          */
         bool operator==(const SideCrossOrderIterator& other) const {
-            return pos == other.pos && &container == &other.container;
+            align(other);
+            return pos == other.pos && container == other.container;
         }
 
         /**
@@ -118,6 +320,43 @@ namespace Container {
         bool operator!=(const SideCrossOrderIterator& other) const {
             return !(*this == other);
         }
+
+        /**
+         * @brief Less-than comparison operator.
+         * @param other Another iterator over the same container.
+         * @return True if this iterator is before other.
+         */
+        bool operator<(const SideCrossOrderIterator& other) const {
+            align(other);
+            return pos < other.pos;
+        }
+
+        /**
+         * @brief Greater-than comparison operator.
+         * @param other Another iterator over the same container.
+         * @return True if this iterator is after other.
+         */
+        bool operator>(const SideCrossOrderIterator& other) const {
+            return other < *this;
+        }
+
+        /**
+         * @brief Less-than-or-equal comparison operator.
+         * @param other Another iterator over the same container.
+         * @return True if this iterator is not after other.
+         */
+        bool operator<=(const SideCrossOrderIterator& other) const {
+            return !(other < *this);
+        }
+
+        /**
+         * @brief Greater-than-or-equal comparison operator.
+         * @param other Another iterator over the same container.
+         * @return True if this iterator is not before other.
+         */
+        bool operator>=(const SideCrossOrderIterator& other) const {
+            return !(*this < other);
+        }
     };
 
 } // namespace Container
@@ -0,0 +1,106 @@
+// Email: shanig7531@gmail.com
+
+#ifndef SMALL_CONTAINER_HPP
+#define SMALL_CONTAINER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+#include "MyContainer.hpp"
+#include "InlineArena.hpp"
+
+namespace Container {
+
+    /**
+     * @brief Holds the inline arena of a SmallContainer.
+     * @details A base class rather than a member, so the arena is constructed before the
+     * MyContainer base that allocates from it, and destroyed after it.
+     * @tparam Bytes Size of the inline buffer.
+     */
+    template<size_t Bytes>
+    struct InlineArenaHolder {
+        InlineArena<Bytes> arena;
+
+        explicit InlineArenaHolder(std::pmr::memory_resource* upstream) : arena(upstream) {}
+    };
+
+    /**
+     * @brief Size of the inline arena a SmallContainer needs to hold n elements without the heap.
+     * @tparam T The type of elements stored in the container.
+     * @param n Number of elements.
+     * @return Bytes for the elements and their shared handle, the ascending and descending permutations
+     * (plus a lazy heap), their shared handles and alignment padding.
+     */
+    template<typename T>
+    constexpr size_t small_container_bytes(size_t n) {
+        return n * sizeof(T) + sizeof(std::pmr::vector<T>) + 64 + 3 * n * sizeof(uint32_t)
+            + 2 * (sizeof(SortedIndex<T>) + 64)
+            + 8 * alignof(std::max_align_t);
+    }
+
+    /**
+     * @brief MyContainer that keeps up to N elements, and the sorted permutations over them, inline.
+     *
+     * @details
+     * Everything the container allocates comes from an arena inside the object, sized for N elements,
+     * both sorted permutations and their shared handles, so filling it with up to N elements and
+     * traversing it in any order does not touch the heap. Beyond that, allocations spill over to the
+     * upstream resource. The arena resets itself whenever everything in it is freed.
+     * A SmallContainer is a MyContainer, so it works with every API and iterator that takes one.
+     * Copies of a SmallContainer get their own arena, and moving one into a plain MyContainer
+     * moves the elements one by one to the default resource, since the arena cannot leave the object.
+     * The object itself is large (the buffer is inline), which is the trade-off for skipping the heap.
+     *
+     * @tparam T The type of elements stored in the container.
+     * @tparam N Number of elements kept without heap allocations.
+     */
+    template<typename T, size_t N = 16>
+    class SmallContainer : private InlineArenaHolder<small_container_bytes<T>(N)>, public MyContainer<T> {
+
+    private:
+        using Holder = InlineArenaHolder<small_container_bytes<T>(N)>;
+
+    public:
+        /**
+         * @brief Creates an empty container with room for N elements.
+         * @param upstream Resource for allocations that do not fit inline.
+         */
+        explicit SmallContainer(std::pmr::memory_resource* upstream = std::pmr::get_default_resource())
+            : Holder(upstream), MyContainer<T>(&this->arena) {
+            this->pin_resource();
+            this->reserve(N);
+        }
+
+        /**
+         * @brief Copy constructor. The copy gets its own arena.
+         * @param other The container to copy from.
+         */
+        SmallContainer(const SmallContainer& other)
+            : Holder(std::pmr::get_default_resource()), MyContainer<T>(&this->arena) {
+            this->pin_resource();
+            this->reserve(N);
+            MyContainer<T>::operator=(other);
+        }
+
+        /**
+         * @brief Copy assignment operator. The elements are copied into this container's arena.
+         * @param other The container to assign from.
+         * @return Reference to this container.
+         */
+        SmallContainer& operator=(const SmallContainer& other) {
+            MyContainer<T>::operator=(other);
+            return *this;
+        }
+
+        /**
+         * @brief Returns the number of inline bytes currently in use.
+         * @return Bytes used in the arena.
+         */
+        size_t inline_bytes_used() const {
+            return this->arena.used();
+        }
+    };
+
+} // namespace Container
+
+#endif
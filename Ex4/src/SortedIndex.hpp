@@ -0,0 +1,433 @@
+// Email: shanig7531@gmail.com
+
+#ifndef SORTED_INDEX_HPP
+#define SORTED_INDEX_HPP
+
+#include <vector>
+#include <variant>
+#include <memory_resource>
+#include <cstdint>
+#include <limits>
+#include <utility>
+#include <type_traits>
+#include <algorithm>
+#include <cstddef>
+#include <mutex>
+#include "IndexSort.hpp"
+
+namespace Container {
+
+    /**
+     * @brief Permutation of a container's indices in sorted order, stored with a fixed index width.
+     *
+     * @details
+     * Equal elements keep their insertion order, in both directions.
+     * An eager permutation is fully sorted when it is built, with the engine IndexSort picks for T.
+     * A lazy permutation only heapifies the indices in O(n) and pops the next position off the heap
+     * when a traversal first reads it, so a caller that stops after k elements pays
+     * O(n + k log n) instead of O(n log n).
+     * The permutation does not keep a pointer to the elements; callers pass them in, which keeps
+     * it valid when the owning container is copied.
+     * A lazy permutation is shared by iterators that may run on different threads, so its pops
+     * happen under a lock; an eager one never changes after it is built and is read without one.
+     *
+     * @tparam T The type of elements being ordered.
+     * @tparam Index Unsigned type of the stored indices, wide enough for every index.
+     */
+    template<typename T, typename Index>
+    class Permutation {
+
+    private:
+        mutable std::pmr::vector<Index> order; // Finalized prefix of the permutation (all of it once complete)
+        mutable std::pmr::vector<Index> heap; // Indices not placed yet, kept as a heap (lazy permutation only)
+        bool descending; // True to order from largest to smallest
+        bool lazy = false; // Built as a heap, so reads may pop and must hold pops
+        mutable std::mutex pops; // Serializes pops of a lazy permutation
+
+        /**
+         * @brief Locks the permutation if reading it may pop, i.e. if it is lazy.
+         * @return The lock, empty for an eager permutation.
+         */
+        std::unique_lock<std::mutex> guard() const {
+            return lazy ? std::unique_lock<std::mutex>(pops) : std::unique_lock<std::mutex>();
+        }
+
+        /**
+         * @brief Moves the next index in sorted order from the heap to the end of the finalized prefix.
+         * @param keys The elements being ordered.
+         */
+        void pop_next(const std::pmr::vector<T>& keys) const {
+            std::pop_heap(heap.begin(), heap.end(),
+                [this, &keys](Index a, Index b) {
+                    return IndexSort::before(b, a, keys, descending);
+                });
+            order.push_back(heap.back());
+            heap.pop_back();
+            if (heap.empty()) {
+                heap.shrink_to_fit(); // Release the heap once the permutation is complete
+            }
+        }
+
+    public:
+        using index_type = Index;
+
+        /**
+         * @brief Creates an empty permutation.
+         * @param desc True to order from largest to smallest.
+         * @param resource Memory resource for the index buffers.
+         */
+        Permutation(bool desc, std::pmr::memory_resource* resource)
+            : order(resource), heap(resource), descending(desc) {}
+
+        /**
+         * @brief Builds the permutation over the given elements.
+         * @details The index buffers come from the same memory resource as the elements.
+         * @param keys The elements to order.
+         * @param desc True to order from largest to smallest.
+         * @param lazy True to defer sorting until positions are read.
+         */
+        Permutation(const std::pmr::vector<T>& keys, bool desc, bool lazy)
+            : Permutation(desc, keys.get_allocator().resource()) {
+            this->lazy = lazy;
+            if (lazy) {
+                heap.resize(keys.size());
+                for (size_t i = 0; i < keys.size(); ++i) {
+                    heap[i] = static_cast<Index>(i);
+                }
+                order.reserve(keys.size());
+                std::make_heap(heap.begin(), heap.end(),
+                    [this, &keys](Index a, Index b) {
+                        return IndexSort::before(b, a, keys, descending);
+                    });
+            } else {
+                IndexSort::sort_indices(order, keys, descending);
+            }
+        }
+
+        /**
+         * @brief Copy constructor. The copy stays in the memory resource of the original.
+         * @details Other threads may be popping the original, so it is locked while copied.
+         * @param other The permutation to copy.
+         */
+        Permutation(const Permutation& other)
+            : Permutation(other.descending, other.order.get_allocator().resource()) {
+            auto lock = other.guard();
+            order = other.order;
+            heap = other.heap;
+            lazy = other.lazy;
+        }
+
+        /**
+         * @brief Move constructor. Only the owner moves a permutation, so no lock is taken.
+         * @param other The permutation to move from.
+         */
+        Permutation(Permutation&& other) noexcept
+            : order(std::move(other.order)), heap(std::move(other.heap)),
+              descending(other.descending), lazy(other.lazy) {}
+
+        /**
+         * @brief Move assignment operator. Only the owner moves a permutation, so no lock is taken.
+         * @param other The permutation to move from.
+         * @return Reference to this permutation.
+         */
+        Permutation& operator=(Permutation&& other) noexcept {
+            order = std::move(other.order);
+            heap = std::move(other.heap);
+            descending = other.descending;
+            lazy = other.lazy;
+            return *this;
+        }
+
+        Permutation& operator=(const Permutation&) = delete;
+
+        /**
+         * @brief Wraps an already sorted permutation.
+         * @param sorted Indices in sorted order.
+         * @param desc True if they are ordered from largest to smallest.
+         * @return The permutation.
+         */
+        static Permutation adopt(std::pmr::vector<Index> sorted, bool desc) {
+            Permutation result(desc, sorted.get_allocator().resource());
+            result.order = std::move(sorted);
+            return result;
+        }
+
+        /**
+         * @brief Builds a descending permutation from an ascending one without sorting again.
+         * @details Walks the ascending permutation backwards in O(n). Runs of equal elements come out
+         * in reverse insertion order that way, so each run is flipped back to match what a
+         * descending sort produces.
+         * @param ascending Ascending permutation over the same elements; completed if it is lazy.
+         * @param keys The elements both permutations order.
+         * @return The descending permutation.
+         */
+        static Permutation reverse_of(const Permutation& ascending, const std::pmr::vector<T>& keys) {
+            const std::pmr::vector<Index>& asc = ascending.complete(keys);
+            Permutation result(true, asc.get_allocator().resource());
+            result.order.assign(asc.rbegin(), asc.rend());
+
+            auto run = result.order.begin();
+            for (auto it = result.order.begin(); it != result.order.end(); ++it) {
+                if (keys[*it] < keys[*run]) {
+                    std::reverse(run, it);
+                    run = it;
+                }
+            }
+            std::reverse(run, result.order.end());
+            return result;
+        }
+
+        /**
+         * @brief Returns the number of indices in the permutation.
+         * @return The size of the permutation.
+         */
+        size_t size() const {
+            auto lock = guard();
+            return order.size() + heap.size();
+        }
+
+        /**
+         * @brief Returns the direction of the permutation.
+         * @return True if it orders from largest to smallest.
+         */
+        bool is_descending() const {
+            return descending;
+        }
+
+        /**
+         * @brief Checks whether the whole permutation is sorted (always true for an eager permutation).
+         * @return True if no position is left on the heap.
+         */
+        bool is_complete() const {
+            auto lock = guard();
+            return heap.empty();
+        }
+
+        /**
+         * @brief Checks whether a position was already sorted, so reading it never touches the elements.
+         * @param pos The position in sorted order.
+         * @return True if the position is in the finalized prefix.
+         */
+        bool known(size_t pos) const {
+            auto lock = guard();
+            return pos < order.size();
+        }
+
+        /**
+         * @brief Returns the element index at a position of the sorted order.
+         * @param pos The position in sorted order, must be less than size().
+         * @param keys The elements the permutation was built over.
+         * @return Index of the element at that position.
+         */
+        size_t at(size_t pos, const std::pmr::vector<T>& keys) const {
+            auto lock = guard();
+            while (order.size() <= pos) {
+                pop_next(keys);
+            }
+            return order[pos];
+        }
+
+        /**
+         * @brief Finishes sorting a lazy permutation.
+         * @param keys The elements the permutation was built over.
+         * @return The whole permutation.
+         */
+        const std::pmr::vector<Index>& complete(const std::pmr::vector<T>& keys) const {
+            auto lock = guard();
+            while (!heap.empty()) {
+                pop_next(keys);
+            }
+            return order;
+        }
+
+        /**
+         * @brief Gives the owner write access to a complete permutation.
+         * @param keys The elements the permutation was built over.
+         * @return The whole permutation.
+         */
+        std::pmr::vector<Index>& indices(const std::pmr::vector<T>& keys) {
+            complete(keys);
+            return order;
+        }
+    };
+
+    /**
+     * @brief Permutation of a container's indices in sorted order, shared by the sorted-order iterators.
+     *
+     * @details
+     * Stores 32-bit indices while the container holds at most 2^32 elements, which halves the
+     * memory and bandwidth of the index compared to size_t, and 64-bit indices beyond that.
+     * The width is picked when the index is built; widen() switches a 32-bit index over when
+     * the container outgrows it.
+     *
+     * @tparam T The type of elements being ordered.
+     */
+    template<typename T>
+    class SortedIndex {
+
+    public:
+        using Narrow = Permutation<T, uint32_t>;
+        using Wide = Permutation<T, size_t>;
+
+    private:
+        std::variant<Narrow, Wide> permutation; // The stored permutation, at the width the size needs
+
+        /**
+         * @brief Wraps a permutation of either width.
+         * @param perm The permutation.
+         */
+        template<typename Index>
+        explicit SortedIndex(Permutation<T, Index> perm) : permutation(std::move(perm)) {}
+
+        /**
+         * @brief Builds a permutation of the width needed for the given elements.
+         * @param keys The elements to order.
+         * @param desc True to order from largest to smallest.
+         * @param lazy True to defer sorting until positions are read.
+         * @return The permutation.
+         */
+        static std::variant<Narrow, Wide> build(const std::pmr::vector<T>& keys, bool desc, bool lazy) {
+            if (fits_narrow(keys.size())) {
+                return Narrow(keys, desc, lazy);
+            }
+            return Wide(keys, desc, lazy);
+        }
+
+    public:
+        /**
+         * @brief Checks whether every index of a container of the given size fits in 32 bits.
+         * @param n The number of elements.
+         * @return True if 32-bit indices are enough.
+         */
+        static bool fits_narrow(size_t n) {
+            return n == 0 || n - 1 <= std::numeric_limits<uint32_t>::max();
+        }
+
+        /**
+         * @brief Builds the index over the given elements.
+         * @param keys The elements to order.
+         * @param desc True to order from largest to smallest.
+         * @param lazy True to defer sorting until positions are read.
+         */
+        SortedIndex(const std::pmr::vector<T>& keys, bool desc, bool lazy)
+            : permutation(build(keys, desc, lazy)) {}
+
+        /**
+         * @brief Wraps an already sorted permutation.
+         * @param sorted Indices in sorted order.
+         * @param desc True if they are ordered from largest to smallest.
+         * @return The index.
+         */
+        template<typename Index>
+        static SortedIndex adopt(std::pmr::vector<Index> sorted, bool desc) {
+            return SortedIndex(Permutation<T, Index>::adopt(std::move(sorted), desc));
+        }
+
+        /**
+         * @brief Builds a descending index from an ascending one without sorting again, at the same width.
+         * @param ascending Ascending index over the same elements; completed if it is lazy.
+         * @param keys The elements both indices order.
+         * @return The descending index.
+         */
+        static SortedIndex reverse_of(const SortedIndex& ascending, const std::pmr::vector<T>& keys) {
+            return ascending.visit([&keys](const auto& perm) {
+                return SortedIndex(std::decay_t<decltype(perm)>::reverse_of(perm, keys));
+            });
+        }
+
+        /**
+         * @brief Calls a function with the stored permutation, as Narrow or Wide.
+         * @param f Callable taking const Narrow& and const Wide&, returning the same type for both.
+         * @return What f returns.
+         */
+        template<typename F>
+        decltype(auto) visit(F&& f) const {
+            if (const Narrow* narrow = std::get_if<Narrow>(&permutation)) {
+                return f(*narrow);
+            }
+            return f(*std::get_if<Wide>(&permutation));
+        }
+
+        /**
+         * @brief Calls a function with the stored permutation, as Narrow or Wide.
+         * @param f Callable taking Narrow& and Wide&, returning the same type for both.
+         * @return What f returns.
+         */
+        template<typename F>
+        decltype(auto) visit(F&& f) {
+            if (Narrow* narrow = std::get_if<Narrow>(&permutation)) {
+                return f(*narrow);
+            }
+            return f(*std::get_if<Wide>(&permutation));
+        }
+
+        /**
+         * @brief Checks whether the index stores 64-bit indices.
+         * @return True for a Wide permutation.
+         */
+        bool wide() const {
+            return permutation.index() == 1;
+        }
+
+        /**
+         * @brief Switches a 32-bit index to 64-bit indices, completing it first.
+         * @param keys The elements the index was built over.
+         */
+        void widen(const std::pmr::vector<T>& keys) {
+            if (Narrow* narrow = std::get_if<Narrow>(&permutation)) {
+                const std::pmr::vector<uint32_t>& order = narrow->complete(keys);
+                std::pmr::vector<size_t> wide(order.begin(), order.end(), order.get_allocator().resource());
+                permutation = Wide::adopt(std::move(wide), narrow->is_descending());
+            }
+        }
+
+        /**
+         * @brief Returns the number of indices in the permutation.
+         * @return The size of the permutation.
+         */
+        size_t size() const {
+            return visit([](const auto& perm) { return perm.size(); });
+        }
+
+        /**
+         * @brief Checks whether the whole permutation is sorted (always true for an eager index).
+         * @return True if no position is left on the heap.
+         */
+        bool is_complete() const {
+            return visit([](const auto& perm) { return perm.is_complete(); });
+        }
+
+        /**
+         * @brief Checks whether a position was already sorted, so reading it never touches the elements.
+         * @param pos The position in sorted order.
+         * @return True if the position is in the finalized prefix.
+         */
+        bool known(size_t pos) const {
+            return visit([pos](const auto& perm) { return perm.known(pos); });
+        }
+
+        /**
+         * @brief Returns the element index at a position of the sorted order.
+         * @param pos The position in sorted order, must be less than size().
+         * @param keys The elements the index was built over.
+         * @return Index of the element at that position.
+         */
+        size_t at(size_t pos, const std::pmr::vector<T>& keys) const {
+            if (const Narrow* narrow = std::get_if<Narrow>(&permutation)) {
+                return narrow->at(pos, keys);
+            }
+            return std::get_if<Wide>(&permutation)->at(pos, keys);
+        }
+
+        /**
+         * @brief Finishes sorting a lazy index.
+         * @param keys The elements the index was built over.
+         */
+        void complete(const std::pmr::vector<T>& keys) const {
+            visit([&keys](const auto& perm) { perm.complete(keys); });
+        }
+    };
+
+} // namespace Container
+
+#endif
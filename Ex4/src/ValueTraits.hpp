@@ -0,0 +1,27 @@
+// Email: shanig7531@gmail.com
+
+#ifndef VALUE_TRAITS_HPP
+#define VALUE_TRAITS_HPP
+
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+#include <utility>
+
+namespace Container {
+
+    /**
+     * @brief Checks whether std::hash is enabled for T, so values can go into unordered containers.
+     * @details A disabled std::hash specialization is not callable, which is what is tested here.
+     * @tparam T The element type.
+     */
+    template<typename T, typename = void>
+    struct is_hashable : std::false_type {};
+
+    template<typename T>
+    struct is_hashable<T, std::void_t<decltype(std::declval<const std::hash<T>&>()(std::declval<const T&>()))>>
+        : std::is_convertible<decltype(std::declval<const std::hash<T>&>()(std::declval<const T&>())), size_t> {};
+
+} // namespace Container
+
+#endif